@@ -18,16 +18,16 @@ _sensor_data() {
     local commands="transform count distinct list-errors summarise-errors stats latest"
     
     # Common options for all commands
-    local common_opts="-r --recursive -v -V -e --extension -d --depth -if --input-format --min-date --max-date"
+    local common_opts="-r --recursive -v -V -e --extension -d --depth -if --input-format --min-date --max-date -j --jobs --io-jobs"
     
     # Command-specific options
-    local transform_opts="-o --output -of --output-format --tail --tail-column-value --use-prototype --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-whitespace --remove-empty-json --update-value --update-where-empty --unique --clean"
-    local count_opts="-o --output -of --output-format -f --follow -b --by-column --by-day --by-week --by-month --by-year --tail --tail-column-value --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-empty-json --unique --clean"
-    local distinct_opts="-c --counts -of --output-format --not-empty --not-null --only-value --exclude-value --allowed-values --after --before --remove-errors --remove-empty-json --clean --unique"
+    local transform_opts="-o --output -of --output-format --tail --tail-column-value --use-prototype --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-whitespace --single-pass --schema-cache --remove-empty-json --update-value --update-where-empty --unique --unique-exact --unique-memory --clean"
+    local count_opts="-o --output -of --output-format -f --follow -b --by-column --by-day --by-week --by-month --by-year --tail --tail-column-value --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-empty-json --unique --unique-exact --unique-memory --clean"
+    local distinct_opts="-c --counts -of --output-format --not-empty --not-null --only-value --exclude-value --allowed-values --after --before --remove-errors --remove-empty-json --clean --unique --unique-exact --unique-memory"
     local list_errors_opts="-o --output"
     local summarise_errors_opts="-o --output"
-    local stats_opts="-c --column -f --follow --tail --tail-column-value -o --output --group-by --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-empty-json --unique --clean"
-    local latest_opts="-n -of --output-format --tail --tail-column-value --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-empty-json --unique --clean"
+    local stats_opts="-c --column -f --follow --refresh-interval --refresh-every --streaming -b --by-column --by-hour --by-day --by-week --by-month --by-year -o --output -of --output-format --tail --tail-column-value --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-empty-json --unique --unique-exact --unique-memory --clean"
+    local latest_opts="-n -of --output-format --tail --tail-column-value --not-empty --not-null --only-value --exclude-value --allowed-values --remove-errors --remove-empty-json --unique --unique-exact --unique-memory --clean"
 
     # Determine which command we're completing for
     local cmd=""
@@ -58,6 +58,11 @@ _sensor_data() {
             _filedir 2>/dev/null || COMPREPLY=($(compgen -f -- "$cur"))
             return
             ;;
+        --schema-cache)
+            # Complete directory names
+            _filedir -d 2>/dev/null || COMPREPLY=($(compgen -d -- "$cur"))
+            return
+            ;;
         -e|--extension)
             # Common sensor file extensions
             COMPREPLY=($(compgen -W ".out .csv .json .log" -- "$cur"))
@@ -68,6 +73,16 @@ _sensor_data() {
             COMPREPLY=($(compgen -W "0 1 2 3 5 10" -- "$cur"))
             return
             ;;
+        -j|--jobs|--io-jobs)
+            # Suggest some common thread counts
+            COMPREPLY=($(compgen -W "1 2 4 8 16 32" -- "$cur"))
+            return
+            ;;
+        --unique-memory)
+            # Suggest some memory budgets in MB
+            COMPREPLY=($(compgen -W "64 128 256 512 1024" -- "$cur"))
+            return
+            ;;
         --tail)
             # Suggest some common tail values
             COMPREPLY=($(compgen -W "10 50 100 500 1000" -- "$cur"))
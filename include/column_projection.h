@@ -0,0 +1,67 @@
+#ifndef COLUMN_PROJECTION_H
+#define COLUMN_PROJECTION_H
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "field_key.h"
+
+/**
+ * ColumnProjection - the columns a reader has to put into each Reading.
+ *
+ * Commands that only look at a few columns (count, latest, distinct,
+ * stats -c) declare them, the filter adds the columns it checks, and the
+ * parsers skip the values of every other key instead of copying them.
+ * Default-constructed it keeps every column.
+ *
+ * Columns are matched by name as well as by key, so the JSON parser can
+ * drop a field before its key is interned.
+ */
+class ColumnProjection {
+public:
+    ColumnProjection() : everything(true) {}
+
+    explicit ColumnProjection(const std::vector<FieldKey>& columns) : everything(false) {
+        for (const auto& column : columns) add(column);
+    }
+
+    void add(FieldKey column) {
+        if (everything || keeps(column)) return;
+        keys.push_back(column);
+        names.push_back(column.str());
+    }
+
+    // Give up on projecting, e.g. when the whole row is fingerprinted
+    void keepAll() {
+        everything = true;
+        keys.clear();
+        names.clear();
+    }
+
+    bool keepsAll() const { return everything; }
+
+    bool keeps(FieldKey column) const {
+        return everything || std::find(keys.begin(), keys.end(), column) != keys.end();
+    }
+
+    bool keeps(std::string_view name) const {
+        return everything || std::find(names.begin(), names.end(), name) != names.end();
+    }
+
+    // Which fields of a CSV row to keep, by position; empty if all of them
+    std::vector<bool> mask(const std::vector<FieldKey>& headers) const {
+        std::vector<bool> keep;
+        if (everything) return keep;
+        keep.reserve(headers.size());
+        for (const auto& header : headers) keep.push_back(keeps(header));
+        return keep;
+    }
+
+private:
+    bool everything;
+    std::vector<FieldKey> keys;
+    std::vector<std::string> names;  // keys[i].str(), for matching unparsed names
+};
+
+#endif // COLUMN_PROJECTION_H
@@ -8,7 +8,7 @@
 #include <map>
 #include <set>
 #include <algorithm>
-#include <future>
+#include <memory>
 #include <mutex>
 
 #include "types.h"
@@ -20,6 +20,7 @@
 #include "file_utils.h"
 #include "data_reader.h"
 #include "file_collector.h"
+#include "thread_pool.h"
 
 /**
  * Base class for command handlers providing shared functionality:
@@ -64,6 +65,16 @@ protected:
     
     // Unique row filtering
     bool uniqueRows;
+    bool uniqueExact;
+    int uniqueMemoryMB;  // --unique-memory: seen-row budget in MB (0 = unbounded)
+    
+    // Parallelism (-j/--jobs)
+    int jobs;
+    
+    // Columns the command reads from each reading, if it declared them with
+    // requireColumns(); readers then skip parsing every other column
+    bool projectColumns;
+    std::vector<std::string> requiredColumns;
     
     // Constructor with default values
     CommandBase() 
@@ -79,7 +90,11 @@ protected:
         , removeEmptyJson(false)
         , tailLines(0)
         , tailColumnValueCount(0)
-        , uniqueRows(false) {}
+        , uniqueRows(false)
+        , uniqueExact(false)
+        , uniqueMemoryMB(0)
+        , jobs(CommonArgParser::defaultJobs())
+        , projectColumns(false) {}
     
     virtual ~CommandBase() = default;
     
@@ -227,6 +242,13 @@ protected:
         tailColumnValueValue = parser.getTailColumnValueValue();
         tailColumnValueCount = parser.getTailColumnValueCount();
         uniqueRows = parser.getUniqueRows();
+        uniqueExact = parser.getUniqueExact();
+        uniqueMemoryMB = parser.getUniqueMemoryMB();
+        jobs = parser.getJobs();
+        
+        // Size the shared pool and file limit before any command uses them
+        ThreadPool::setSharedSize(static_cast<size_t>(jobs));
+        DataReader::setMaxOpenFiles(static_cast<size_t>(parser.getIoJobs()));
     }
     
     /**
@@ -240,6 +262,8 @@ protected:
         if (tailColumnValueCount > 0) {
             reader.setTailColumnValue(tailColumnValueColumn, tailColumnValueValue, tailColumnValueCount);
         }
+        configureChunkThreads(reader);
+        configureProjection(reader);
         return reader;
     }
     
@@ -253,9 +277,55 @@ protected:
         if (tailColumnValueCount > 0) {
             reader.setTailColumnValue(tailColumnValueColumn, tailColumnValueValue, tailColumnValueCount);
         }
+        configureChunkThreads(reader);
+        configureProjection(reader);
         return reader;
     }
     
+    /**
+     * Create a DataReader for a worker whose --unique is decided later, by
+     * claiming ReadingFilter::uniqueKey() in file order. It filters but keeps
+     * duplicates and leaves update rules to the caller, so keys are taken
+     * from readings as read, as the sequential path does.
+     */
+    DataReader createDeferredUniqueReader(bool rejectMode = false) const {
+        DataReader reader = createDataReader(rejectMode);
+        reader.getFilter().setUniqueRows(false);
+        reader.getFilter().setUpdateRules({});
+        return reader;
+    }
+    
+    /**
+     * processFilesParallel reads two or fewer files sequentially, so in that
+     * case let the reader split each large file across threads instead.
+     */
+    void configureChunkThreads(DataReader& reader) const {
+        if (inputFiles.size() <= 2) {
+            reader.setChunkThreads(static_cast<size_t>(jobs));
+        }
+    }
+    
+    /**
+     * Declare the only columns this command reads from each reading, so
+     * readers can skip parsing the rest. The filter's own columns are added
+     * by the reader. Call after copyFromParser().
+     */
+    void requireColumns(std::vector<std::string> columns) {
+        projectColumns = true;
+        requiredColumns = std::move(columns);
+    }
+    
+    /**
+     * Pass the declared columns on to a reader. --unique compares whole
+     * rows, including where a deferred reader leaves it to the caller, so
+     * then every column is kept.
+     */
+    void configureProjection(DataReader& reader) const {
+        if (projectColumns && !uniqueRows) {
+            reader.setRequiredColumns(requiredColumns);
+        }
+    }
+    
     /**
      * Configure a ReadingFilter with all filter options from CommandBase.
      * Use this when you need a filter but are doing custom parsing.
@@ -272,6 +342,10 @@ protected:
         filter.setInvertFilter(rejectMode);
         filter.setUpdateRules(updateRules);
         filter.setUniqueRows(uniqueRows);
+        filter.setExactUnique(uniqueExact);
+        if (uniqueRows && uniqueMemoryMB > 0) {
+            filter.setUniqueMemoryLimit(static_cast<size_t>(uniqueMemoryMB) * 1024 * 1024);
+        }
     }
     
     /**
@@ -423,22 +497,23 @@ protected:
         const char* sp = compact ? "" : " ";
         outfile << "{" << sp;
         
-        // Sort keys for consistent output order
-        std::vector<std::string> keys;
-        keys.reserve(reading.size());
-        for (const auto& [key, value] : reading) {
-            keys.push_back(key);
+        // Sort fields by key for consistent output order (pointers, not copies)
+        std::vector<const Reading::value_type*> fields;
+        fields.reserve(reading.size());
+        for (const auto& field : reading) {
+            fields.push_back(&field);
         }
-        std::sort(keys.begin(), keys.end());
+        std::sort(fields.begin(), fields.end(),
+                  [](const Reading::value_type* a, const Reading::value_type* b) { return a->first < b->first; });
         
         bool first = true;
-        for (const auto& key : keys) {
+        for (const auto* field : fields) {
             if (!first) outfile << "," << sp;
             first = false;
-            outfile << "\"" << escapeJsonString(key) << "\":" << sp;
+            outfile << "\"" << escapeJsonString(field->first) << "\":" << sp;
             
             // Check if value is a number, boolean, or null
-            const std::string& val = reading.at(key);
+            const std::string& val = field->second;
             if (val == "null" || val.empty()) {
                 outfile << "null";
             } else if (val == "true" || val == "false") {
@@ -453,12 +528,39 @@ protected:
     }
     
     /**
-     * Process files in parallel using multiple threads.
+     * Indices into files ordered largest file first, for scheduling on the
+     * shared pool. Files whose size cannot be read go last, in list order.
+     */
+    static std::vector<size_t> largestFirst(const std::vector<std::string>& files) {
+        std::vector<long long> sizes(files.size());
+        std::vector<size_t> order(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            sizes[i] = FileUtils::getFileSize(files[i]);
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+            return sizes[a] > sizes[b];
+        });
+        return order;
+    }
+    
+    /**
+     * True when processFilesParallel and processFilesParallelVoid handle
+     * files one after another, in order, on the calling thread.
+     */
+    static bool readsSequentially(size_t fileCount, int numThreads) {
+        return fileCount <= 2 || numThreads <= 1;
+    }
+    
+    /**
+     * Process files in parallel on the shared work-stealing pool.
+     * Files are scheduled largest first; per-file results are combined in
+     * the order of files, so the combined result does not depend on timing.
      * @param files Vector of file paths to process
      * @param processFunc Function to call for each file (takes filename, returns result of type T)
-     * @param combineFunc Function to combine results (takes accumulator ref and result, modifies accumulator in-place)
+     * @param combineFunc Function to combine results (takes accumulator ref and result ref, modifies accumulator in-place; may move from the result)
      * @param initialValue Initial value for the accumulator
-     * @param numThreads Number of threads to use (default: 4)
+     * @param numThreads Number of jobs (-j); 1 processes files sequentially on the calling thread
      * @return Combined result
      */
     template<typename T, typename ProcessFunc, typename CombineFunc>
@@ -466,87 +568,71 @@ protected:
                                    ProcessFunc processFunc,
                                    CombineFunc combineFunc,
                                    T initialValue,
-                                   size_t numThreads = 4) {
+                                   int numThreads) {
         if (files.empty()) {
             return initialValue;
         }
         
         // For small number of files, process sequentially
-        if (files.size() <= 2 || numThreads <= 1) {
+        if (readsSequentially(files.size(), numThreads)) {
             T result = initialValue;
             for (const auto& file : files) {
-                combineFunc(result, processFunc(file));
+                T local = processFunc(file);
+                combineFunc(result, local);
             }
             return result;
         }
         
+        // Results wait here until every earlier file has been combined
         std::mutex resultMutex;
         T combinedResult = initialValue;
+        std::vector<std::unique_ptr<T>> pending(files.size());
+        size_t nextToCombine = 0;
         
-        size_t filesPerThread = std::max(size_t(1), files.size() / numThreads);
-        std::vector<std::future<void>> futures;
-        futures.reserve(numThreads);
-        
-        for (size_t i = 0; i < files.size(); i += filesPerThread) {
-            size_t end = std::min(i + filesPerThread, files.size());
+        std::vector<size_t> order = largestFirst(files);
+        ThreadPool::shared().forEach(order.size(), [&](size_t task) {
+            size_t index = order[task];
+            auto result = std::make_unique<T>(processFunc(files[index]));
             
-            futures.push_back(std::async(std::launch::async, [&, i, end]() {
-                T localResult = initialValue;
-                for (size_t j = i; j < end; ++j) {
-                    combineFunc(localResult, processFunc(files[j]));
-                }
-                
-                std::lock_guard<std::mutex> lock(resultMutex);
-                combineFunc(combinedResult, localResult);
-            }));
-        }
-        
-        for (auto& f : futures) {
-            f.wait();
-        }
+            std::lock_guard<std::mutex> lock(resultMutex);
+            pending[index] = std::move(result);
+            while (nextToCombine < pending.size() && pending[nextToCombine]) {
+                combineFunc(combinedResult, *pending[nextToCombine]);
+                pending[nextToCombine].reset();
+                ++nextToCombine;
+            }
+        });
         
         return combinedResult;
     }
     
     /**
-     * Process files in parallel, calling a void function for each file.
+     * Process files in parallel on the shared pool, calling a void function for each file.
+     * Files are scheduled largest first.
      * @param files Vector of file paths to process
      * @param processFunc Function to call for each file (takes filename)
-     * @param numThreads Number of threads to use (default: 4)
+     * @param numThreads Number of jobs (-j); 1 processes files sequentially on the calling thread
      */
     template<typename ProcessFunc>
     static void processFilesParallelVoid(const std::vector<std::string>& files,
                                           ProcessFunc processFunc,
-                                          size_t numThreads = 4) {
+                                          int numThreads) {
         if (files.empty()) {
             return;
         }
         
         // For small number of files, process sequentially
-        if (files.size() <= 2 || numThreads <= 1) {
+        if (readsSequentially(files.size(), numThreads)) {
             for (const auto& file : files) {
                 processFunc(file);
             }
             return;
         }
         
-        size_t filesPerThread = std::max(size_t(1), files.size() / numThreads);
-        std::vector<std::future<void>> futures;
-        futures.reserve(numThreads);
-        
-        for (size_t i = 0; i < files.size(); i += filesPerThread) {
-            size_t end = std::min(i + filesPerThread, files.size());
-            
-            futures.push_back(std::async(std::launch::async, [&, i, end]() {
-                for (size_t j = i; j < end; ++j) {
-                    processFunc(files[j]);
-                }
-            }));
-        }
-        
-        for (auto& f : futures) {
-            f.wait();
-        }
+        std::vector<size_t> order = largestFirst(files);
+        ThreadPool::shared().forEach(order.size(), [&](size_t task) {
+            processFunc(files[order[task]]);
+        });
     }
 };
 
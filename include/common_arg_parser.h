@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <map>
 #include <set>
+#include <thread>
 #include "date_utils.h"
 #include "file_collector.h"
 #include "reading_filter.h"  // For UpdateRule
@@ -41,14 +42,27 @@ private:
     std::string tailColumnValueValue;
     int tailColumnValueCount;
     
-    // Unique row filtering
+    // Unique row filtering (--unique-exact compares whole rows, not fingerprints;
+    // --unique-memory caps the seen-row set in MB, spilling to disk beyond it)
     bool uniqueRows;
+    bool uniqueExact;
+    int uniqueMemoryMB;
+    
+    // Parallelism: -j/--jobs worker threads, --io-jobs files read at once (0 = no limit)
+    int jobs;
+    int ioJobs;
     
 public:
+    // Default for -j: one worker per hardware thread
+    static int defaultJobs() {
+        unsigned int n = std::thread::hardware_concurrency();
+        return n > 0 ? static_cast<int>(n) : 1;
+    }
+    
     CommonArgParser() 
         : recursive(false), extensionFilter(""), maxDepth(-1), verbosity(0), 
           inputFormat(DEFAULT_INPUT_FORMAT), minDate(0), maxDate(0), removeEmptyJson(false), removeErrors(false),
-          tailLines(0), tailColumnValueCount(0), uniqueRows(false) {}
+          tailLines(0), tailColumnValueCount(0), uniqueRows(false), uniqueExact(false), uniqueMemoryMB(0), jobs(defaultJobs()), ioJobs(0) {}
     
     // Parse common arguments and collect files
     // Returns true if parsing should continue, false if help was shown or error occurred
@@ -116,6 +130,29 @@ public:
                     std::cerr << "Error: --tail requires a number argument" << std::endl;
                     return false;
                 }
+            } else if (arg == "-j" || arg == "--jobs" || arg == "--io-jobs") {
+                if (i + 1 < argc) {
+                    ++i;
+                    int n;
+                    try {
+                        n = std::stoi(argv[i]);
+                    } catch (...) {
+                        std::cerr << "Error: invalid value for " << arg << ": " << argv[i] << std::endl;
+                        return false;
+                    }
+                    if (n <= 0) {
+                        std::cerr << "Error: " << arg << " requires a positive number" << std::endl;
+                        return false;
+                    }
+                    if (arg == "--io-jobs") {
+                        ioJobs = n;
+                    } else {
+                        jobs = n;
+                    }
+                } else {
+                    std::cerr << "Error: " << arg << " requires a number argument" << std::endl;
+                    return false;
+                }
             } else if (arg == "--tail-column-value") {
                 // --tail-column-value column:value n - return last n rows where column=value
                 if (i + 2 < argc) {
@@ -143,7 +180,7 @@ public:
                     std::cerr << "Error: --tail-column-value requires 'column:value n'" << std::endl;
                     return false;
                 }
-            } else if (arg == "-o" || arg == "--output") {
+            } else if (arg == "-o" || arg == "--output" || arg == "--schema-cache") {
                 // Skip this flag and its argument - handled by SensorDataTransformer
                 if (i + 1 < argc) {
                     ++i;
@@ -170,6 +207,27 @@ public:
                 removeErrors = true;
             } else if (arg == "--unique") {
                 uniqueRows = true;
+            } else if (arg == "--unique-exact") {
+                uniqueRows = true;
+                uniqueExact = true;
+            } else if (arg == "--unique-memory") {
+                if (i + 1 < argc) {
+                    ++i;
+                    try {
+                        uniqueMemoryMB = std::stoi(argv[i]);
+                    } catch (...) {
+                        std::cerr << "Error: invalid value for --unique-memory: " << argv[i] << std::endl;
+                        return false;
+                    }
+                    if (uniqueMemoryMB <= 0) {
+                        std::cerr << "Error: --unique-memory requires a positive number of MB" << std::endl;
+                        return false;
+                    }
+                    uniqueRows = true;
+                } else {
+                    std::cerr << "Error: --unique-memory requires a number argument" << std::endl;
+                    return false;
+                }
             } else if (arg == "--clean") {
                 // --clean expands to --remove-empty-json --not-empty value --remove-errors --not-null value --not-null sensor_id --unique
                 removeEmptyJson = true;
@@ -352,6 +410,11 @@ public:
             // Unknown flags are ignored here - let each class handle their specific flags
         }
         
+        if (uniqueExact && uniqueMemoryMB > 0) {
+            std::cerr << "Error: --unique-memory cannot be combined with --unique-exact" << std::endl;
+            return false;
+        }
+        
         inputFiles = collector.getSortedFiles();
         return true;
     }
@@ -378,6 +441,10 @@ public:
     const std::string& getTailColumnValueValue() const noexcept { return tailColumnValueValue; }
     int getTailColumnValueCount() const noexcept { return tailColumnValueCount; }
     bool getUniqueRows() const noexcept { return uniqueRows; }
+    bool getUniqueExact() const noexcept { return uniqueExact; }
+    int getUniqueMemoryMB() const noexcept { return uniqueMemoryMB; }
+    int getJobs() const noexcept { return jobs; }
+    int getIoJobs() const noexcept { return ioJobs; }
     
     /**
      * Check for unknown options in command line arguments.
@@ -393,14 +460,15 @@ public:
         static const std::set<std::string> commonOptions = {
             "-r", "--recursive", "-v", "-V", "-if", "--input-format",
             "-e", "--extension", "-d", "--depth", "--min-date", "--max-date",
-            "--tail", "--tail-column-value", "-h", "--help"
+            "--tail", "--tail-column-value", "-j", "--jobs", "--io-jobs", "-h", "--help"
         };
         
         // Common filtering options
         static const std::set<std::string> filterOptions = {
             "--not-empty", "--not-null", "--only-value", "--exclude-value", "--allowed-values",
             "--remove-errors", "--remove-empty-json", "--clean", "--use-prototype",
-            "--update-value", "--update-where-empty", "--remove-whitespace", "--unique"
+            "--update-value", "--update-where-empty", "--remove-whitespace", "--unique",
+            "--unique-exact", "--unique-memory"
         };
         
         // Options that take arguments (need to skip the next arg)
@@ -409,7 +477,8 @@ public:
             "-if", "--input-format", "-e", "--extension", "-d", "--depth",
             "--min-date", "--max-date", "--not-empty", "--not-null", "--only-value", 
             "--exclude-value", "--allowed-values", "-o", "--output", "-of", "--output-format",
-            "-c", "--column", "--tail", "--tail-column-value"
+            "-c", "--column", "--tail", "--tail-column-value", "-j", "--jobs", "--io-jobs",
+            "--schema-cache", "--unique-memory"
         };
         
         for (int i = 1; i < argc; ++i) {
@@ -2,17 +2,32 @@
 #define CSV_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
+#include "field_key.h"
 
 class CsvParser {
 public:
     // Parse CSV line considering proper escaping and quoting
     // Note: This parser handles multi-line fields by reading additional lines when needed
-    static std::vector<std::string> parseCsvLine(std::istream& input, std::string& line, bool& needMoreLines);
+    // If keep is given, fields at positions it marks false (or past its end)
+    // are scanned but left empty, as are they in parseCsvRecord()
+    static std::vector<std::string> parseCsvLine(std::istream& input, std::string& line, bool& needMoreLines,
+                                                 const std::vector<bool>* keep = nullptr);
     
     // Simpler version for single-line parsing (backwards compatibility)
     static std::vector<std::string> parseCsvLine(const std::string& line);
+    
+    // Parse a header line and intern each column name, so rows can be keyed
+    // by FieldKey without looking names up again
+    static std::vector<FieldKey> parseCsvHeader(std::istream& input, std::string& line, bool& needMoreLines);
+    
+    // Parse one record from an in-memory buffer starting at pos, following
+    // newlines inside quoted fields. pos is left at the start of the next record.
+    static std::vector<std::string> parseCsvRecord(std::string_view data, size_t& pos,
+                                                   const std::vector<bool>* keep = nullptr);
+    static std::vector<FieldKey> parseCsvHeader(std::string_view data, size_t& pos);
 };
 
 #endif // CSV_PARSER_H
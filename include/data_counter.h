@@ -34,6 +34,26 @@ private:
     std::unordered_map<std::string, long long> valueCounts;  // counts per column value
     std::mutex valueCountsMutex;  // mutex for thread-safe access to valueCounts
     
+    // The --by-* period; byDay wins over byWeek over byMonth over byYear
+    DateUtils::Period timePeriod() const {
+        if (byDay) return DateUtils::Period::Day;
+        if (byWeek) return DateUtils::Period::Week;
+        if (byMonth) return DateUtils::Period::Month;
+        return DateUtils::Period::Year;
+    }
+    
+    /**
+     * Add one reading to a file's counts: its --by-column value to counts,
+     * and its --by-* period to periodCounts, keyed by DateUtils::periodKey
+     * so that no label is formatted per row.
+     */
+    void tally(const Reading& reading, std::unordered_map<std::string, long long>& counts,
+               std::unordered_map<long long, long long>& periodCounts) const;
+    
+    // Fold period counts into counts under their labels (e.g. "2024-03")
+    void addPeriodCounts(const std::unordered_map<long long, long long>& periodCounts,
+                         std::unordered_map<std::string, long long>& counts) const;
+    
     /**
      * Count readings from a single file (returns count, updates valueCounts thread-safely)
      */
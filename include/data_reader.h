@@ -9,11 +9,17 @@
 #include <utility>
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <string_view>
 #include "types.h"
 #include "csv_parser.h"
 #include "json_parser.h"
 #include "file_utils.h"
 #include "reading_filter.h"
+#include "thread_pool.h"
 
 /**
  * DataReader - Centralized data reader with integrated filtering.
@@ -44,6 +50,56 @@ private:
     std::string tailColumnValueValue;
     int tailColumnValueCount;
     
+    // Scratch space for the zero-copy JSON parser, reused across lines
+    JsonLineViews jsonViews;
+    
+    // Columns the caller reads (setRequiredColumns); all when not projecting
+    bool projecting;
+    std::vector<FieldKey> requiredColumns;
+    
+    // Threads used to parse a single large file (1 = sequential), and the
+    // approximate bytes per chunk, a share of one round; buffers under two
+    // chunks stay sequential
+    size_t chunkThreads;
+    size_t chunkBytes;
+    
+    /**
+     * Process-wide cap on files being read at once (--io-jobs), so slow
+     * storage is not hit by every worker thread together. 0 = no cap.
+     */
+    struct OpenFileLimit {
+        std::mutex mutex;
+        std::condition_variable released;
+        size_t limit = 0;
+        size_t active = 0;
+    };
+    
+    static OpenFileLimit& openFileLimit() {
+        static OpenFileLimit state;
+        return state;
+    }
+    
+    // Holds one --io-jobs slot for its lifetime
+    class OpenFileSlot {
+    public:
+        OpenFileSlot() : state(openFileLimit()) {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.released.wait(lock, [this]() { return state.limit == 0 || state.active < state.limit; });
+            state.active++;
+        }
+        ~OpenFileSlot() {
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.active--;
+            }
+            state.released.notify_one();
+        }
+        OpenFileSlot(const OpenFileSlot&) = delete;
+        OpenFileSlot& operator=(const OpenFileSlot&) = delete;
+    private:
+        OpenFileLimit& state;
+    };
+    
     // Get the active filter (shared or owned)
     ReadingFilter& filter() {
         return sharedFilter ? *sharedFilter : ownedFilter;
@@ -52,15 +108,179 @@ private:
         return sharedFilter ? *sharedFilter : ownedFilter;
     }
     
+    // The columns parsers must produce: the caller's plus the filter's
+    ColumnProjection projection() const {
+        if (!projecting) return ColumnProjection();
+        ColumnProjection columns(requiredColumns);
+        filter().addCheckedColumns(columns);
+        return columns;
+    }
+    
+    // Pair CSV fields with their headers, leaving out positions keep (if
+    // not empty) marks as unwanted
+    static Reading csvReading(const std::vector<FieldKey>& headers, std::vector<std::string>& fields,
+                              const std::vector<bool>& keep) {
+        Reading reading;
+        reading.reserve(headers.size());
+        for (size_t i = 0; i < std::min(headers.size(), fields.size()); ++i) {
+            if (keep.empty() || keep[i]) {
+                reading.emplace(headers[i], std::move(fields[i]));
+            }
+        }
+        return reading;
+    }
+    
+    /**
+     * Parse every record in data, calling emit(reading, recordNum) for each
+     * one with recordNum counting from 1. Records are lines, except that a
+     * quoted CSV field may span lines; empty lines are counted but skipped,
+     * and so are lines the prefilter (if any) rules out. Readings only hold
+     * the fields columns keeps.
+     * Returns the number of records seen.
+     */
+    template<typename Emit>
+    static int parseRecords(std::string_view data, bool isCSV, const std::vector<FieldKey>& csvHeaders,
+                            JsonLineViews& views, const RawLinePrefilter* prefilter,
+                            const ColumnProjection& columns, Emit emit) {
+        size_t pos = 0;
+        int recordNum = 0;
+        
+        if (isCSV) {
+            std::vector<bool> keep = columns.mask(csvHeaders);
+            while (pos < data.size()) {
+                recordNum++;
+                if (data[pos] == '\n') {
+                    ++pos;
+                    continue;
+                }
+                
+                if (prefilter) {
+                    const char* start = data.data() + pos;
+                    const char* nl = static_cast<const char*>(std::memchr(start, '\n', data.size() - pos));
+                    std::string_view line(start, nl ? static_cast<size_t>(nl - start) : data.size() - pos);
+                    if (RawLinePrefilter::isPlainCsvLine(line) && !prefilter->mayMatch(line)) {
+                        pos += line.size() + 1;
+                        continue;
+                    }
+                }
+                
+                auto fields = CsvParser::parseCsvRecord(data, pos, keep.empty() ? nullptr : &keep);
+                if (fields.empty()) continue;
+                
+                Reading reading = csvReading(csvHeaders, fields, keep);
+                emit(reading, recordNum);
+            }
+        } else {
+            Reading reading;
+            while (pos < data.size()) {
+                const char* start = data.data() + pos;
+                const char* nl = static_cast<const char*>(std::memchr(start, '\n', data.size() - pos));
+                size_t len = nl ? static_cast<size_t>(nl - start) : data.size() - pos;
+                std::string_view line(start, len);
+                pos += len + 1;
+                
+                recordNum++;
+                if (line.empty()) continue;
+                if (prefilter && !prefilter->mayMatch(line)) continue;
+                
+                JsonParser::parseJsonLineViews(line, views);
+                for (size_t i = 0; i < views.size(); ++i) {
+                    JsonParser::toReading(views[i], reading, columns);
+                    emit(reading, recordNum);
+                }
+            }
+        }
+        return recordNum;
+    }
+    
+    /**
+     * Find the end of the chunk that starts at record boundary `begin` and
+     * should end near `target`: the byte after the first newline at or past
+     * target that is not inside a quoted CSV field.
+     */
+    static size_t findChunkEnd(std::string_view data, size_t begin, size_t target, bool isCSV) {
+        if (target >= data.size()) return data.size();
+        
+        if (!isCSV) {
+            const void* nl = std::memchr(data.data() + target, '\n', data.size() - target);
+            return nl ? static_cast<size_t>(static_cast<const char*>(nl) - data.data()) + 1 : data.size();
+        }
+        
+        // The CSV parser is inside quotes exactly when it has seen an odd
+        // number of quote characters since the last record boundary
+        bool inQuotes = std::count(data.data() + begin, data.data() + target, '"') % 2 != 0;
+        for (size_t i = target; i < data.size(); ++i) {
+            if (data[i] == '"') {
+                inQuotes = !inQuotes;
+            } else if (data[i] == '\n' && !inQuotes) {
+                return i + 1;
+            }
+        }
+        return data.size();
+    }
+    
+    /**
+     * Parse and filter a large buffer in chunks on the shared thread pool.
+     *
+     * The buffer is processed in rounds of chunkThreads chunks that share
+     * one round's bytes, so at most one round of matching readings is held
+     * in memory however many threads there are. Workers parse and
+     * apply the filters; the calling thread then replays each chunk's
+     * readings in file order, applying --unique and transformations, so
+     * callbacks, line numbers and output order match sequential reading.
+     */
+    template<typename Callback>
+    void processChunksParallel(std::string_view data, bool isCSV, const std::vector<FieldKey>& csvHeaders,
+                               int lineNum, Callback& callback, const std::string& sourceName) {
+        struct ChunkResult {
+            std::vector<std::pair<int, Reading>> readings;  // (record number in chunk, reading)
+            int records = 0;
+        };
+        
+        const ReadingFilter& activeFilter = filter();
+        const RawLinePrefilter* prefilter = activeFilter.rawLinePrefilter();
+        const ColumnProjection columns = projection();
+        size_t pos = 0;
+        
+        while (pos < data.size()) {
+            std::vector<std::string_view> chunks;
+            for (size_t t = 0; t < chunkThreads && pos < data.size(); ++t) {
+                size_t end = findChunkEnd(data, pos, pos + chunkBytes, isCSV);
+                chunks.push_back(data.substr(pos, end - pos));
+                pos = end;
+            }
+            
+            std::vector<ChunkResult> results(chunks.size());
+            ThreadPool::shared().forEach(chunks.size(), [&](size_t c) {
+                ChunkResult& result = results[c];
+                JsonLineViews views;
+                result.records = parseRecords(chunks[c], isCSV, csvHeaders, views, prefilter, columns, [&](Reading& reading, int recordNum) {
+                    if (activeFilter.matches(reading)) {
+                        result.readings.emplace_back(recordNum, std::move(reading));
+                    }
+                });
+            });
+            
+            for (auto& result : results) {
+                for (auto& [recordNum, reading] : result.readings) {
+                    if (!activeFilter.isFirstOccurrence(reading)) continue;
+                    activeFilter.applyTransformations(reading);
+                    callback(reading, lineNum + recordNum, sourceName);
+                }
+                lineNum += result.records;
+            }
+        }
+    }
+    
 public:
     DataReader(int verbosity = 0, const std::string& format = "auto", int tailLines = 0)
-        : sharedFilter(nullptr), verbosity(verbosity), inputFormat(format), tailLines(tailLines), tailColumnValueCount(0) {
+        : sharedFilter(nullptr), verbosity(verbosity), inputFormat(format), tailLines(tailLines), tailColumnValueCount(0), projecting(false), chunkThreads(1), chunkBytes(DEFAULT_ROUND_BYTES) {
         ownedFilter.setVerbosity(verbosity);
     }
     
     // Constructor that uses a shared filter (for thread-safe --unique across files)
     DataReader(ReadingFilter& shared, int verbosity = 0, const std::string& format = "auto", int tailLines = 0)
-        : sharedFilter(&shared), verbosity(verbosity), inputFormat(format), tailLines(tailLines), tailColumnValueCount(0) {
+        : sharedFilter(&shared), verbosity(verbosity), inputFormat(format), tailLines(tailLines), tailColumnValueCount(0), projecting(false), chunkThreads(1), chunkBytes(DEFAULT_ROUND_BYTES) {
     }
     
     // Set tail-column-value filter (reads file backwards for efficiency)
@@ -70,6 +290,43 @@ public:
         tailColumnValueCount = count;
     }
     
+    /**
+     * Declare the only columns the callback reads. Readings from whole-file
+     * and stream reads then hold just those and the ones the filter checks,
+     * as the parsers skip the rest; --tail paths still parse every column.
+     */
+    void setRequiredColumns(const std::vector<std::string>& columns) {
+        projecting = true;
+        requiredColumns.assign(columns.begin(), columns.end());
+    }
+    
+    static constexpr size_t DEFAULT_ROUND_BYTES = 16 * 1024 * 1024;
+    
+    // Allow a single large file to be parsed on up to n threads, which split
+    // bytesPerRound between them at a time. Readings still reach the
+    // callback in file order, on the calling thread.
+    void setChunkThreads(size_t n, size_t bytesPerRound = DEFAULT_ROUND_BYTES) {
+        chunkThreads = std::max(size_t(1), n);
+        chunkBytes = std::max(size_t(1), bytesPerRound / chunkThreads);
+    }
+    
+    // Limit how many files all readers may read at once; 0 removes the limit
+    static void setMaxOpenFiles(size_t n) {
+        OpenFileLimit& state = openFileLimit();
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.limit = n;
+        }
+        state.released.notify_all();
+    }
+    
+    // The limit set by setMaxOpenFiles(); 0 means none
+    static size_t maxOpenFiles() {
+        OpenFileLimit& state = openFileLimit();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.limit;
+    }
+    
     // Get mutable reference to filter for configuration
     ReadingFilter& getFilter() {
         return filter();
@@ -95,30 +352,29 @@ public:
     void processStream(std::istream& input, bool isCSV, Callback callback, const std::string& sourceName) {
         std::string line;
         int lineNum = 0;
+        const RawLinePrefilter* prefilter = filter().rawLinePrefilter();
+        const ColumnProjection columns = projection();
         
         if (isCSV) {
             // CSV format - first line is header
-            std::vector<std::string> csvHeaders;
+            std::vector<FieldKey> csvHeaders;
             if (std::getline(input, line) && !line.empty()) {
                 lineNum++;
                 bool needMore = false;
-                csvHeaders = CsvParser::parseCsvLine(input, line, needMore);
+                csvHeaders = CsvParser::parseCsvHeader(input, line, needMore);
             }
+            std::vector<bool> keep = columns.mask(csvHeaders);
             
             while (std::getline(input, line)) {
                 lineNum++;
                 if (line.empty()) continue;
+                if (prefilter && RawLinePrefilter::isPlainCsvLine(line) && !prefilter->mayMatch(line)) continue;
                 
                 bool needMore = false;
-                auto fields = CsvParser::parseCsvLine(input, line, needMore);
+                auto fields = CsvParser::parseCsvLine(input, line, needMore, keep.empty() ? nullptr : &keep);
                 if (fields.empty()) continue;
                 
-                // Create a map from CSV headers to values
-                Reading reading;
-                reading.reserve(csvHeaders.size());
-                for (size_t i = 0; i < std::min(csvHeaders.size(), fields.size()); ++i) {
-                    reading.emplace(csvHeaders[i], std::move(fields[i]));
-                }
+                Reading reading = csvReading(csvHeaders, fields, keep);
                 
                 // Apply ALL filters here
                 if (!filter().shouldInclude(reading)) continue;
@@ -129,14 +385,17 @@ public:
                 callback(reading, lineNum, sourceName);
             }
         } else {
-            // JSON format
+            // JSON format - parse into views over the line buffer and only
+            // materialize each object once, into a Reading reused across rows
+            Reading reading;
             while (std::getline(input, line)) {
                 lineNum++;
                 if (line.empty()) continue;
+                if (prefilter && !prefilter->mayMatch(line)) continue;
                 
-                auto readings = JsonParser::parseJsonLine(line);
-                for (auto reading : readings) {  // Copy to allow mutation
-                    if (reading.empty()) continue;
+                JsonParser::parseJsonLineViews(line, jsonViews);
+                for (size_t i = 0; i < jsonViews.size(); ++i) {
+                    JsonParser::toReading(jsonViews[i], reading, columns);
                     
                     // Apply ALL filters here
                     if (!filter().shouldInclude(reading)) continue;
@@ -150,6 +409,43 @@ public:
         }
     }
     
+    // Same as processStream, but over a whole file already in memory (see
+    // MappedFile). Lines are located with memchr and parsed in place, so JSON
+    // input is never copied into a line buffer. Large buffers are split
+    // across threads when setChunkThreads() allows it.
+    template<typename Callback>
+    void processBuffer(std::string_view data, bool isCSV, Callback callback, const std::string& sourceName) {
+        size_t pos = 0;
+        int lineNum = 0;
+        
+        // CSV format - first line is header
+        std::vector<FieldKey> csvHeaders;
+        if (isCSV && pos < data.size()) {
+            if (data[pos] == '\n') {
+                ++pos;
+            } else {
+                lineNum++;
+                csvHeaders = CsvParser::parseCsvHeader(data, pos);
+            }
+        }
+        data.remove_prefix(pos);
+        
+        if (chunkThreads > 1 && data.size() >= 2 * chunkBytes) {
+            processChunksParallel(data, isCSV, csvHeaders, lineNum, callback, sourceName);
+            return;
+        }
+        
+        parseRecords(data, isCSV, csvHeaders, jsonViews, filter().rawLinePrefilter(), projection(), [&](Reading& reading, int recordNum) {
+            // Apply ALL filters here
+            if (!filter().shouldInclude(reading)) return;
+            
+            // Apply transformations (updates) after filtering
+            filter().applyTransformations(reading);
+            
+            callback(reading, lineNum + recordNum, sourceName);
+        });
+    }
+    
     // Process readings from stdin
     template<typename Callback>
     void processStdin(Callback callback) {
@@ -170,6 +466,8 @@ public:
             }
         }
         
+        OpenFileSlot slot;
+        
         // Determine format: explicit "csv"/"json" overrides, "auto" detects from extension
         bool isCSV;
         if (inputFormat == "csv") {
@@ -192,7 +490,7 @@ public:
             matchingLines.reserve(tailColumnValueCount);
             
             // For CSV, we need the header first
-            std::vector<std::string> csvHeaders;
+            std::vector<FieldKey> csvHeaders;
             std::string headerLine;
             if (isCSV) {
                 std::ifstream headerFile(filename);
@@ -202,15 +500,26 @@ public:
                 }
                 if (std::getline(headerFile, headerLine) && !headerLine.empty()) {
                     bool needMore = false;
-                    csvHeaders = CsvParser::parseCsvLine(headerFile, headerLine, needMore);
+                    csvHeaders = CsvParser::parseCsvHeader(headerFile, headerLine, needMore);
                 }
                 headerFile.close();
             }
             
+            // Lines without the wanted value (or without what the value
+            // filters need) can be skipped unparsed
+            RawLinePrefilter tailValue;
+            tailValue.require({tailColumnValueValue});
+            const RawLinePrefilter* prefilter = filter().rawLinePrefilter();
+            auto mayMatch = [&](const std::string& line) {
+                if (isCSV && !RawLinePrefilter::isPlainCsvLine(line)) return true;
+                return tailValue.mayMatch(line) && (!prefilter || prefilter->mayMatch(line));
+            };
+            
             // Read file backwards, collecting matching lines
             FileUtils::readLinesReverse(filename, [&](const std::string& line) -> bool {
                 if (line.empty()) return true;  // continue
                 if (isCSV && line == headerLine) return true;  // skip header
+                if (!mayMatch(line)) return true;
                 
                 // Parse and check for match
                 if (isCSV) {
@@ -278,6 +587,7 @@ public:
         }
         
         if (tailLines > 0) {
+            const RawLinePrefilter* prefilter = filter().rawLinePrefilter();
             // Use tail mode
             if (isCSV) {
                 // CSV: read header from file, then process tail lines
@@ -287,10 +597,10 @@ public:
                     return;
                 }
                 std::string headerLine;
-                std::vector<std::string> csvHeaders;
+                std::vector<FieldKey> csvHeaders;
                 if (std::getline(headerFile, headerLine) && !headerLine.empty()) {
                     bool needMore = false;
-                    csvHeaders = CsvParser::parseCsvLine(headerFile, headerLine, needMore);
+                    csvHeaders = CsvParser::parseCsvHeader(headerFile, headerLine, needMore);
                 }
                 headerFile.close();
                 
@@ -304,6 +614,7 @@ public:
                     if (line.empty()) continue;
                     // Skip if this is the header line (can happen with small files)
                     if (line == headerLine) continue;
+                    if (prefilter && RawLinePrefilter::isPlainCsvLine(line) && !prefilter->mayMatch(line)) continue;
                     
                     auto fields = CsvParser::parseCsvLine(line);
                     if (fields.empty()) continue;
@@ -330,6 +641,7 @@ public:
                 for (const auto& line : lines) {
                     lineNum++;
                     if (line.empty()) continue;
+                    if (prefilter && !prefilter->mayMatch(line)) continue;
                     
                     auto readings = JsonParser::parseJsonLine(line);
                     for (auto reading : readings) {  // Copy to allow mutation
@@ -346,12 +658,22 @@ public:
                 }
             }
         } else {
-            // Use larger buffer for better I/O performance
+            // Map regular files and parse them in place; pipes and other
+            // non-seekable inputs fall through to stream reading
+            MappedFile mapped;
+            if (mapped.open(filename)) {
+                processBuffer(mapped.data(), isCSV, callback, filename);
+                return;
+            }
+            
+            // Use larger buffer for better I/O performance. Allocated here:
+            // a thread_local array would be zeroed for every thread, once
+            // per instantiation of this template
             static constexpr size_t BUFFER_SIZE = 256 * 1024;  // 256KB buffer
-            static thread_local char buffer[BUFFER_SIZE];
+            std::vector<char> buffer(BUFFER_SIZE);
             
             std::ifstream infile;
-            infile.rdbuf()->pubsetbuf(buffer, BUFFER_SIZE);
+            infile.rdbuf()->pubsetbuf(buffer.data(), BUFFER_SIZE);
             infile.open(filename);
             
             if (!infile) {
@@ -418,12 +740,21 @@ public:
      */
     template<typename Callback>
     void processStdinFollow(Callback callback) {
+        processStdinFollow(callback, [] {});
+    }
+    
+    /**
+     * As above, and call onIdle each time stdin has no more input for now
+     * (every 100ms while it stays that way).
+     */
+    template<typename Callback, typename IdleCallback>
+    void processStdinFollow(Callback callback, IdleCallback onIdle) {
         if (verbosity >= 1) {
             std::cerr << "Reading from stdin with follow mode..." << std::endl;
         }
         
         std::string line;
-        std::vector<std::string> csvHeaders;
+        std::vector<FieldKey> csvHeaders;
         bool headerParsed = false;
         bool isCSV = (inputFormat == "csv");
         int lineNum = 0;
@@ -436,7 +767,7 @@ public:
                 if (isCSV) {
                     if (!headerParsed) {
                         bool needMore = false;
-                        csvHeaders = CsvParser::parseCsvLine(std::cin, line, needMore);
+                        csvHeaders = CsvParser::parseCsvHeader(std::cin, line, needMore);
                         headerParsed = true;
                         continue;
                     }
@@ -473,6 +804,7 @@ public:
                 }
             } else {
                 std::cin.clear();
+                onIdle();
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
         }
@@ -485,6 +817,15 @@ public:
      */
     template<typename Callback>
     void processFileFollow(const std::string& filename, Callback callback) {
+        processFileFollow(filename, callback, [] {});
+    }
+    
+    /**
+     * As above, and call onIdle each time the reader has caught up with the
+     * end of the file (every 100ms until more is written).
+     */
+    template<typename Callback, typename IdleCallback>
+    void processFileFollow(const std::string& filename, Callback callback, IdleCallback onIdle) {
         if (verbosity >= 1) {
             std::cerr << "Following file: " << filename << std::endl;
         }
@@ -496,7 +837,7 @@ public:
         }
         
         std::string line;
-        std::vector<std::string> csvHeaders;
+        std::vector<FieldKey> csvHeaders;
         bool isCSV = FileUtils::isCsvFile(filename);
         int lineNum = 0;
         
@@ -505,7 +846,7 @@ public:
             if (std::getline(infile, line) && !line.empty()) {
                 lineNum++;
                 bool needMore = false;
-                csvHeaders = CsvParser::parseCsvLine(infile, line, needMore);
+                csvHeaders = CsvParser::parseCsvHeader(infile, line, needMore);
             }
         }
         
@@ -548,6 +889,7 @@ public:
                 }
             } else {
                 infile.clear();
+                onIdle();
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
         }
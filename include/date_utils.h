@@ -2,8 +2,10 @@
 #define DATE_UTILS_H
 
 #include <string>
+#include <string_view>
 #include <ctime>
 #include <cctype>
+#include <limits>
 #include "types.h"
 
 // Date/Time utility functions
@@ -28,24 +30,120 @@ namespace DateUtils {
         return true;
     }
     
+    // Days from 1970-01-01 to a proleptic Gregorian date (Howard Hinnant's
+    // days_from_civil)
+    inline long long daysFromCivil(long long year, int month, int day) {
+        year -= month <= 2;
+        const long long era = (year >= 0 ? year : year - 399) / 400;
+        const long long yoe = year - era * 400;                                // [0, 399]
+        const long long doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;  // [0, 365]
+        const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           // [0, 146096]
+        return era * 146097 + doe - 719468;
+    }
+    
+    /**
+     * Convert a wall-clock time in the local time zone (TZ) to a Unix
+     * timestamp. This is what mktime() gives for a struct tm with tm_isdst
+     * = 0, so in zones with daylight saving the time is read as standard
+     * time. Dates without a zone have always been read this way.
+     *
+     * mktime() is slow (it consults the zone database), so it is only asked
+     * for the offset once per hour of wall time, which is cached per thread.
+     * Zone transitions fall on whole hours, and TZ is not changed at run time.
+     */
+    inline long long localTimeToTimestamp(int year, int month, int day, int hour, int min, int sec) {
+        long long wall = daysFromCivil(year, month, day) * 86400 + hour * 3600LL + min * 60 + sec;
+        long long hourStart = wall - (wall % 3600 + 3600) % 3600;
+        
+        struct OffsetCache {
+            long long hourStart = std::numeric_limits<long long>::min();
+            long long offset = 0;
+        };
+        static thread_local OffsetCache cache;
+        if (cache.hourStart != hourStart) {
+            struct tm timeinfo = {};
+            timeinfo.tm_year = year - 1900;
+            timeinfo.tm_mon = month - 1;
+            timeinfo.tm_mday = day;
+            timeinfo.tm_hour = hour;
+            timeinfo.tm_min = min;
+            timeinfo.tm_sec = sec;
+            cache.offset = static_cast<long long>(mktime(&timeinfo)) - wall;
+            cache.hourStart = hourStart;
+        }
+        return wall + cache.offset;
+    }
+    
+    // Value of the two digits at s[pos], or -1 if they aren't digits
+    inline int twoDigits(std::string_view s, size_t pos) {
+        if (!std::isdigit(static_cast<unsigned char>(s[pos])) ||
+            !std::isdigit(static_cast<unsigned char>(s[pos + 1]))) {
+            return -1;
+        }
+        return (s[pos] - '0') * 10 + (s[pos + 1] - '0');
+    }
+    
+    /**
+     * Fast path for the two formats timestamps come in: a Unix timestamp of
+     * up to 18 digits (optionally negative), and YYYY-MM-DD with an optional
+     * THH:MM:SS. Sets result and returns true if dateStr is one of those;
+     * anything else is left to the general parser, which handles the
+     * looser forms sscanf accepts, so the result is always the same.
+     */
+    inline bool parseDateFast(std::string_view dateStr, int defaultHour, int defaultMin, int defaultSec,
+                              long long& result) {
+        size_t start = (!dateStr.empty() && dateStr[0] == '-') ? 1 : 0;
+        size_t length = dateStr.size();
+        if (length > start && length - start <= 18) {
+            long long value = 0;
+            size_t i = start;
+            while (i < length && std::isdigit(static_cast<unsigned char>(dateStr[i]))) {
+                value = value * 10 + (dateStr[i++] - '0');
+            }
+            if (i == length) {
+                result = start ? -value : value;
+                return true;
+            }
+        }
+        
+        if (length < 10 || dateStr[4] != '-' || dateStr[7] != '-') return false;
+        if (length > 10 && std::isdigit(static_cast<unsigned char>(dateStr[10]))) return false;
+        int yearHigh = twoDigits(dateStr, 0), yearLow = twoDigits(dateStr, 2);
+        int month = twoDigits(dateStr, 5), day = twoDigits(dateStr, 8);
+        if (yearHigh < 0 || yearLow < 0 || month < 0 || day < 0) return false;
+        int year = yearHigh * 100 + yearLow;
+        
+        int hour = defaultHour, min = defaultMin, sec = defaultSec;
+        if (length > 10 && dateStr[10] == 'T') {
+            if (length < 19 || dateStr[13] != ':' || dateStr[16] != ':') return false;
+            if (length > 19 && std::isdigit(static_cast<unsigned char>(dateStr[19]))) return false;
+            hour = twoDigits(dateStr, 11);
+            min = twoDigits(dateStr, 14);
+            sec = twoDigits(dateStr, 17);
+            if (hour < 0 || min < 0 || sec < 0) return false;
+        } else if (dateStr.find('T', 10) != std::string_view::npos) {
+            return false;  // time further along, as the general parser reads it
+        }
+        
+        result = isValidDateTime(year, month, day, hour, min, sec)
+            ? localTimeToTimestamp(year, month, day, hour, min, sec) : 0;
+        return true;
+    }
+    
     // Internal helper for parsing dates with configurable default time
     // defaultHour/Min/Sec used when no time component is specified
     inline long long parseDateInternal(const std::string& dateStr, int defaultHour, int defaultMin, int defaultSec) {
         if (dateStr.empty()) return 0;
         
+        long long fast;
+        if (parseDateFast(dateStr, defaultHour, defaultMin, defaultSec, fast)) return fast;
+        
         // Try DD/MM/YYYY format first
         if (dateStr.find('/') != std::string::npos) {
             int day, month, year;
             if (sscanf(dateStr.c_str(), "%d/%d/%d", &day, &month, &year) == 3) {
                 if (!isValidDateTime(year, month, day)) return 0;
-                struct tm timeinfo = {};
-                timeinfo.tm_year = year - 1900;
-                timeinfo.tm_mon = month - 1;
-                timeinfo.tm_mday = day;
-                timeinfo.tm_hour = defaultHour;
-                timeinfo.tm_min = defaultMin;
-                timeinfo.tm_sec = defaultSec;
-                return static_cast<long long>(mktime(&timeinfo));
+                return localTimeToTimestamp(year, month, day, defaultHour, defaultMin, defaultSec);
             }
         }
         
@@ -60,15 +158,7 @@ namespace DateUtils {
                 }
                 
                 if (!isValidDateTime(year, month, day, hour, min, sec)) return 0;
-                
-                struct tm timeinfo = {};
-                timeinfo.tm_year = year - 1900;
-                timeinfo.tm_mon = month - 1;
-                timeinfo.tm_mday = day;
-                timeinfo.tm_hour = hour;
-                timeinfo.tm_min = min;
-                timeinfo.tm_sec = sec;
-                return static_cast<long long>(mktime(&timeinfo));
+                return localTimeToTimestamp(year, month, day, hour, min, sec);
             }
         }
         
@@ -106,7 +196,7 @@ namespace DateUtils {
     
     // Parse timestamp from reading (handles both string and numeric timestamps)
     inline long long getTimestamp(const Reading& reading) {
-        auto it = reading.find("timestamp");
+        auto it = reading.find(Keys::Timestamp);
         if (it == reading.end() || it->second.empty()) {
             return 0;
         }
@@ -133,71 +223,113 @@ namespace DateUtils {
         return true;
     }
 
+    // Inverse of daysFromCivil (Howard Hinnant's civil_from_days)
+    inline void civilFromDays(long long days, long long& year, int& month, int& day) {
+        days += 719468;
+        const long long era = (days >= 0 ? days : days - 146096) / 146097;
+        const long long doe = days - era * 146097;                                    // [0, 146096]
+        const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+        const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+        const long long mp = (5 * doy + 2) / 153;                                     // [0, 11]
+        day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        year = yoe + era * 400 + (month <= 2);
+    }
+    
+    // Calendar periods timestamps are grouped by (count --by-day etc.)
+    enum class Period { Hour, Day, Week, Month, Year };
+    
+    // Period key of a timestamp with no usable date
+    inline constexpr long long NO_PERIOD = std::numeric_limits<long long>::min();
+    
+    /**
+     * The UTC period a timestamp falls in, as an integer that orders like
+     * the period: the hour or day number since the epoch, the month ordinal
+     * (year * 12 + month - 1),
+     * the year, or the ISO week as isoYear * 100 + week. Group on these and
+     * only format the distinct keys with periodLabel(). NO_PERIOD where
+     * getTimeInfo() fails: timestamps <= 0, or beyond what gmtime handles.
+     */
+    inline long long periodKey(long long timestamp, Period period) {
+        if (timestamp <= 0) return NO_PERIOD;
+        long long days = timestamp / 86400;
+        long long year;
+        int month, day;
+        civilFromDays(days, year, month, day);
+        if (year - 1900 > std::numeric_limits<int>::max()) return NO_PERIOD;
+        
+        switch (period) {
+            case Period::Hour:
+                return timestamp / 3600;
+            case Period::Day:
+                return days;
+            case Period::Month:
+                return year * 12 + (month - 1);
+            case Period::Year:
+                return year;
+            case Period::Week: {
+                // The ISO week belongs to the year of its Thursday; 1970-01-01 was one
+                int isoWday = static_cast<int>((days + 3) % 7);  // 0=Monday, 6=Sunday
+                long long thursday = days - isoWday + 3;
+                long long isoYear;
+                civilFromDays(thursday, isoYear, month, day);
+                long long week = (thursday - daysFromCivil(isoYear, 1, 1)) / 7 + 1;
+                return isoYear * 100 + week;
+            }
+        }
+        return NO_PERIOD;
+    }
+    
+    // Label of a periodKey(): YYYY-MM-DD HH:00, YYYY-MM-DD, YYYY-Www, YYYY-MM or YYYY
+    inline std::string periodLabel(long long key, Period period) {
+        if (key == NO_PERIOD) return "(no-date)";
+        char buf[48];
+        switch (period) {
+            case Period::Hour: {
+                long long year;
+                int month, day;
+                civilFromDays(key / 24, year, month, day);
+                snprintf(buf, sizeof(buf), "%04lld-%02d-%02d %02lld:00", year, month, day, key % 24);
+                break;
+            }
+            case Period::Day: {
+                long long year;
+                int month, day;
+                civilFromDays(key, year, month, day);
+                snprintf(buf, sizeof(buf), "%04lld-%02d-%02d", year, month, day);
+                break;
+            }
+            case Period::Week:
+                snprintf(buf, sizeof(buf), "%04lld-W%02lld", key / 100, key % 100);
+                break;
+            case Period::Month:
+                snprintf(buf, sizeof(buf), "%04lld-%02lld", key / 12, key % 12 + 1);
+                break;
+            case Period::Year:
+                snprintf(buf, sizeof(buf), "%04lld", key);
+                break;
+        }
+        return std::string(buf);
+    }
+
     // Convert timestamp to YYYY-MM format
     inline std::string timestampToMonth(long long timestamp) {
-        struct tm tm_info;
-        if (!getTimeInfo(timestamp, tm_info)) return "(no-date)";
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%04d-%02d", tm_info.tm_year + 1900, tm_info.tm_mon + 1);
-        return std::string(buf);
+        return periodLabel(periodKey(timestamp, Period::Month), Period::Month);
     }
 
     // Convert timestamp to YYYY-MM-DD format
     inline std::string timestampToDay(long long timestamp) {
-        struct tm tm_info;
-        if (!getTimeInfo(timestamp, tm_info)) return "(no-date)";
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d", tm_info.tm_year + 1900, tm_info.tm_mon + 1, tm_info.tm_mday);
-        return std::string(buf);
+        return periodLabel(periodKey(timestamp, Period::Day), Period::Day);
     }
 
     // Convert timestamp to YYYY format
     inline std::string timestampToYear(long long timestamp) {
-        struct tm tm_info;
-        if (!getTimeInfo(timestamp, tm_info)) return "(no-date)";
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%04d", tm_info.tm_year + 1900);
-        return std::string(buf);
+        return periodLabel(periodKey(timestamp, Period::Year), Period::Year);
     }
 
     // Convert timestamp to YYYY-Www format (ISO week number)
-    // Manual calculation since %G and %V aren't portable
     inline std::string timestampToWeek(long long timestamp) {
-        struct tm tm_info;
-        if (!getTimeInfo(timestamp, tm_info)) return "(no-date)";
-        
-        int year = tm_info.tm_year + 1900;
-        int yday = tm_info.tm_yday;  // 0-365
-        int wday = tm_info.tm_wday;  // 0=Sunday, 6=Saturday
-        
-        // Convert Sunday=0 to Monday=0 system (ISO uses Monday as first day)
-        int isoWday = (wday == 0) ? 6 : wday - 1;  // 0=Monday, 6=Sunday
-        
-        // Find the Thursday of this week
-        int thursdayYday = yday - isoWday + 3;  // Thursday is day 3 (0-indexed from Monday)
-        
-        // Handle year boundaries
-        if (thursdayYday < 0) {
-            // Thursday is in previous year
-            year--;
-            bool prevLeap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-            thursdayYday += prevLeap ? 366 : 365;
-        } else {
-            bool thisLeap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-            int daysInYear = thisLeap ? 366 : 365;
-            if (thursdayYday >= daysInYear) {
-                // Thursday is in next year
-                year++;
-                thursdayYday -= daysInYear;
-            }
-        }
-        
-        // Week number is (thursdayYday / 7) + 1
-        int weekNum = (thursdayYday / 7) + 1;
-        
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%04d-W%02d", year, weekNum);
-        return std::string(buf);
+        return periodLabel(periodKey(timestamp, Period::Week), Period::Week);
     }
 }
 
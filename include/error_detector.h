@@ -8,7 +8,7 @@
 // Structure to hold an error definition loaded from config
 struct ErrorDefinition {
     std::string sensor;      // Sensor name (case-insensitive match)
-    std::string field;       // Field to check (e.g., "value", "temperature")
+    FieldKey field;          // Field to check (e.g., "value", "temperature")
     std::string value;       // Error value to match
     std::string description; // Human-readable error description
 };
@@ -26,6 +26,9 @@ public:
     // Get a description of the error, or empty string if no error
     static std::string getErrorDescription(const Reading& reading);
     
+    // Columns the checks above look at: sensor and every defined field
+    static std::vector<FieldKey> getCheckedColumns();
+    
 private:
     static std::vector<ErrorDefinition> errorDefinitions;
     static bool definitionsLoaded;
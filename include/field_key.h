@@ -0,0 +1,213 @@
+#ifndef FIELD_KEY_H
+#define FIELD_KEY_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Field names known at compile time. Their IDs are their positions in this
+ * table, so the Keys:: constants below need no lookup at runtime.
+ * Index 0 is the empty name, which is also what a default FieldKey holds.
+ */
+inline constexpr std::string_view kBuiltinFieldNames[] = {
+    "",
+    "sensor_id",
+    "timestamp",
+    "value",
+    "sensor",
+    "unit",
+    "measures",
+    "name",
+};
+
+/**
+ * FieldKeyTable - process-wide dictionary of field names.
+ *
+ * Each distinct name is stored once and gets a small integer ID. Names are
+ * never removed, so references returned by name() stay valid for the life of
+ * the process.
+ *
+ * intern() checks a per-thread cache before taking the table lock, so
+ * parsing threads only contend the first time they see a name. name() is
+ * lock-free: names live in chunks whose addresses are published with
+ * release/acquire and never move. Each chunk is twice the size of the one
+ * before, so the few chunk slots cover every 32-bit ID and the table grows
+ * as far as memory allows.
+ */
+class FieldKeyTable {
+public:
+    static FieldKeyTable& instance() {
+        static FieldKeyTable table;
+        return table;
+    }
+
+    uint32_t intern(std::string_view name) {
+        thread_local std::unordered_map<std::string_view, uint32_t> cache;
+        auto cached = cache.find(name);
+        if (cached != cache.end()) return cached->second;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t id = internLocked(name);
+        // Key the cache on the table's copy, which outlives the caller's buffer
+        cache.emplace(this->name(id), id);
+        return id;
+    }
+
+    const std::string& name(uint32_t id) const {
+        uint32_t offset;
+        uint32_t chunkIndex = locate(id, offset);
+        return chunks[chunkIndex].load(std::memory_order_acquire)[offset];
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+private:
+    static constexpr uint32_t kChunkBits = 10;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits;  // size of the first chunk
+    static constexpr uint32_t kMaxChunks = 32 - kChunkBits + 1;
+
+    std::atomic<std::string*> chunks[kMaxChunks] = {};
+    std::unordered_map<std::string_view, uint32_t> ids;  // views into chunk storage
+    uint32_t count = 0;
+    mutable std::mutex mutex;
+
+    FieldKeyTable() {
+        for (std::string_view builtin : kBuiltinFieldNames) {
+            internLocked(builtin);
+        }
+    }
+
+    ~FieldKeyTable() {
+        for (auto& chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    FieldKeyTable(const FieldKeyTable&) = delete;
+    FieldKeyTable& operator=(const FieldKeyTable&) = delete;
+
+    // Chunk k holds IDs [kChunkSize * (2^k - 1), kChunkSize * (2^(k+1) - 1))
+    static uint32_t locate(uint32_t id, uint32_t& offset) {
+        uint64_t biased = uint64_t(id) + kChunkSize;
+        uint32_t chunkIndex = static_cast<uint32_t>(63 - __builtin_clzll(biased)) - kChunkBits;
+        offset = static_cast<uint32_t>(biased - (uint64_t(kChunkSize) << chunkIndex));
+        return chunkIndex;
+    }
+
+    uint32_t internLocked(std::string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+
+        uint32_t id = count;
+        uint32_t offset;
+        uint32_t chunkIndex = locate(id, offset);
+        std::string* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new std::string[size_t(kChunkSize) << chunkIndex];
+            chunks[chunkIndex].store(chunk, std::memory_order_release);
+        }
+        std::string& stored = chunk[offset];
+        stored.assign(name);
+        ids.emplace(std::string_view(stored), id);
+        ++count;
+        return id;
+    }
+};
+
+/**
+ * FieldKey - an interned field name.
+ *
+ * Holds only the name's ID, so copying and comparing keys is an integer
+ * operation. Converts implicitly to const std::string& so code written
+ * against string keys keeps working, and constructs implicitly from strings
+ * so lookups like reading.find("value") still compile (at the cost of an
+ * intern() call; prefer the Keys:: constants on hot paths).
+ *
+ * Ordering compares names, not IDs, so sorted containers of keys iterate
+ * alphabetically as they did with string keys.
+ */
+class FieldKey {
+public:
+    constexpr FieldKey() : keyId(0) {}
+    FieldKey(std::string_view name) : keyId(FieldKeyTable::instance().intern(name)) {}
+    FieldKey(const std::string& name) : FieldKey(std::string_view(name)) {}
+    FieldKey(const char* name) : FieldKey(std::string_view(name)) {}
+
+    static constexpr FieldKey fromId(uint32_t id) { return FieldKey(id, 0); }
+
+    constexpr uint32_t id() const { return keyId; }
+    const std::string& str() const { return FieldKeyTable::instance().name(keyId); }
+    operator const std::string&() const { return str(); }
+
+    bool empty() const { return str().empty(); }
+    size_t size() const { return str().size(); }
+    const char* c_str() const { return str().c_str(); }
+
+    friend constexpr bool operator==(FieldKey a, FieldKey b) { return a.keyId == b.keyId; }
+    friend constexpr bool operator!=(FieldKey a, FieldKey b) { return a.keyId != b.keyId; }
+
+    friend bool operator==(FieldKey a, std::string_view b) { return a.str() == b; }
+    friend bool operator==(std::string_view a, FieldKey b) { return a == b.str(); }
+    friend bool operator==(FieldKey a, const std::string& b) { return a.str() == b; }
+    friend bool operator==(const std::string& a, FieldKey b) { return a == b.str(); }
+    friend bool operator==(FieldKey a, const char* b) { return a.str() == b; }
+    friend bool operator==(const char* a, FieldKey b) { return a == b.str(); }
+    friend bool operator!=(FieldKey a, std::string_view b) { return !(a == b); }
+    friend bool operator!=(std::string_view a, FieldKey b) { return !(a == b); }
+    friend bool operator!=(FieldKey a, const std::string& b) { return !(a == b); }
+    friend bool operator!=(const std::string& a, FieldKey b) { return !(a == b); }
+    friend bool operator!=(FieldKey a, const char* b) { return !(a == b); }
+    friend bool operator!=(const char* a, FieldKey b) { return !(a == b); }
+
+    friend bool operator<(FieldKey a, FieldKey b) { return a.keyId != b.keyId && a.str() < b.str(); }
+    friend bool operator>(FieldKey a, FieldKey b) { return b < a; }
+    friend bool operator<=(FieldKey a, FieldKey b) { return !(b < a); }
+    friend bool operator>=(FieldKey a, FieldKey b) { return !(a < b); }
+
+    friend std::ostream& operator<<(std::ostream& os, FieldKey key) { return os << key.str(); }
+
+private:
+    uint32_t keyId;
+
+    constexpr FieldKey(uint32_t id, int) : keyId(id) {}
+};
+
+namespace std {
+template<>
+struct hash<FieldKey> {
+    size_t operator()(FieldKey key) const noexcept { return std::hash<uint32_t>()(key.id()); }
+};
+}
+
+/**
+ * Compile-time keys for the fields every command touches.
+ */
+namespace Keys {
+    inline constexpr FieldKey SensorId = FieldKey::fromId(1);
+    inline constexpr FieldKey Timestamp = FieldKey::fromId(2);
+    inline constexpr FieldKey Value = FieldKey::fromId(3);
+    inline constexpr FieldKey Sensor = FieldKey::fromId(4);
+    inline constexpr FieldKey Unit = FieldKey::fromId(5);
+    inline constexpr FieldKey Measures = FieldKey::fromId(6);
+    inline constexpr FieldKey Name = FieldKey::fromId(7);
+
+    static_assert(kBuiltinFieldNames[SensorId.id()] == "sensor_id");
+    static_assert(kBuiltinFieldNames[Timestamp.id()] == "timestamp");
+    static_assert(kBuiltinFieldNames[Value.id()] == "value");
+    static_assert(kBuiltinFieldNames[Sensor.id()] == "sensor");
+    static_assert(kBuiltinFieldNames[Unit.id()] == "unit");
+    static_assert(kBuiltinFieldNames[Measures.id()] == "measures");
+    static_assert(kBuiltinFieldNames[Name.id()] == "name");
+}
+
+#endif // FIELD_KEY_H
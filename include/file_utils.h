@@ -2,6 +2,7 @@
 #define FILE_UTILS_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -42,6 +43,32 @@ public:
     static int readLinesReverse(const std::string& filename, Callback callback);
 };
 
+/**
+ * MappedFile - read-only memory mapping of a whole regular file.
+ *
+ * open() fails for anything that is not a regular file (pipes, FIFOs,
+ * character devices) and on platforms without mmap, so callers can fall
+ * back to stream reading. The mapping is advised as sequential access.
+ * An empty file opens successfully with an empty view.
+ */
+class MappedFile {
+public:
+    MappedFile() : addr(nullptr), length(0) {}
+    ~MappedFile() { close(); }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const std::string& filename);
+    void close();
+    
+    std::string_view data() const { return std::string_view(static_cast<const char*>(addr), length); }
+    
+private:
+    void* addr;
+    size_t length;
+};
+
 // Template implementation
 template<typename Callback>
 int FileUtils::readLinesReverse(const std::string& filename, Callback callback) {
@@ -0,0 +1,181 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "types.h"
+
+/**
+ * Fingerprint - 128-bit hash of a whole reading, used by --unique.
+ *
+ * Each field is hashed on its own (MurmurHash3 x64/128 of the value, seeded
+ * by the interned key ID) and the field hashes are summed, so the result
+ * does not depend on field order and needs no sorting. Key IDs are only
+ * stable within one process, and so are fingerprints.
+ */
+struct Fingerprint {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    friend bool operator==(const Fingerprint& a, const Fingerprint& b) {
+        return a.lo == b.lo && a.hi == b.hi;
+    }
+    friend bool operator!=(const Fingerprint& a, const Fingerprint& b) {
+        return !(a == b);
+    }
+
+    static Fingerprint of(const Reading& reading) {
+        uint64_t lo = 0, hi = 0;
+        for (const auto& [key, value] : reading) {
+            Fingerprint field = hashBytes(value.data(), value.size(),
+                                          (key.id() + 1) * 0x9e3779b97f4a7c15ULL);
+            lo += field.lo;
+            hi += field.hi;
+        }
+        uint64_t count = reading.size();
+        return {fmix64(lo ^ count), fmix64(hi + count)};
+    }
+
+    // MurmurHash3 x64/128
+    static Fingerprint hashBytes(const void* key, size_t len, uint64_t seed) {
+        const uint8_t* data = static_cast<const uint8_t*>(key);
+        const size_t nblocks = len / 16;
+        const uint64_t c1 = 0x87c37b91114253d5ULL;
+        const uint64_t c2 = 0x4cf5ad432745937fULL;
+        uint64_t h1 = seed, h2 = seed;
+
+        for (size_t i = 0; i < nblocks; ++i) {
+            uint64_t k1, k2;
+            std::memcpy(&k1, data + i * 16, 8);
+            std::memcpy(&k2, data + i * 16 + 8, 8);
+
+            k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+            h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+            k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+            h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+        }
+
+        size_t rest = len & 15;
+        if (rest > 0) {
+            uint8_t tail[16] = {0};
+            std::memcpy(tail, data + nblocks * 16, rest);
+            uint64_t k1, k2;
+            std::memcpy(&k1, tail, 8);
+            std::memcpy(&k2, tail + 8, 8);
+            if (rest > 8) {
+                k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+            }
+            k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        }
+
+        h1 ^= len; h2 ^= len;
+        h1 += h2; h2 += h1;
+        h1 = fmix64(h1); h2 = fmix64(h2);
+        h1 += h2; h2 += h1;
+        return {h1, h2};
+    }
+
+private:
+    static uint64_t rotl64(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t fmix64(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+};
+
+/**
+ * FingerprintSet - open-addressing (linear probing) set of fingerprints.
+ * 16 bytes per slot and no per-entry allocation. Not thread-safe.
+ */
+class FingerprintSet {
+public:
+    FingerprintSet() : slots(MIN_SLOTS), count(0) {}
+
+    // True if fp was not in the set yet
+    bool insert(Fingerprint fp) {
+        if (isEmpty(fp)) fp.lo = 1;  // all-zero marks a free slot
+        if ((count + 1) * 10 > slots.size() * 7) {
+            grow();
+        }
+        if (!place(fp)) return false;
+        ++count;
+        return true;
+    }
+
+    bool contains(Fingerprint fp) const {
+        if (isEmpty(fp)) fp.lo = 1;
+        size_t mask = slots.size() - 1;
+        for (size_t i = fp.lo & mask; !isEmpty(slots[i]); i = (i + 1) & mask) {
+            if (slots[i] == fp) return true;
+        }
+        return false;
+    }
+
+    size_t size() const { return count; }
+
+    size_t memoryBytes() const { return slots.size() * sizeof(Fingerprint); }
+
+    // memoryBytes() once one more new fingerprint has been inserted
+    size_t memoryBytesAfterInsert() const {
+        return (count + 1) * 10 > slots.size() * 7 ? memoryBytes() * 2 : memoryBytes();
+    }
+
+    /**
+     * Empty the set and hand back its fingerprints, in no particular order,
+     * reusing the slot array so no second copy is held.
+     */
+    std::vector<Fingerprint> release() {
+        std::vector<Fingerprint> entries;
+        entries.swap(slots);
+        entries.erase(std::remove_if(entries.begin(), entries.end(), isEmpty), entries.end());
+        clear();
+        return entries;
+    }
+
+    void clear() {
+        slots.assign(MIN_SLOTS, Fingerprint());
+        count = 0;
+    }
+
+private:
+    static constexpr size_t MIN_SLOTS = 16;  // power of two
+
+    std::vector<Fingerprint> slots;
+    size_t count;
+
+    static bool isEmpty(const Fingerprint& fp) {
+        return fp.lo == 0 && fp.hi == 0;
+    }
+
+    bool place(const Fingerprint& fp) {
+        size_t mask = slots.size() - 1;
+        size_t i = fp.lo & mask;
+        while (!isEmpty(slots[i])) {
+            if (slots[i] == fp) return false;
+            i = (i + 1) & mask;
+        }
+        slots[i] = fp;
+        return true;
+    }
+
+    void grow() {
+        std::vector<Fingerprint> old(slots.size() * 2);
+        old.swap(slots);
+        for (const auto& fp : old) {
+            if (!isEmpty(fp)) place(fp);
+        }
+    }
+};
+
+#endif // FINGERPRINT_H
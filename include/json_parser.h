@@ -2,13 +2,81 @@
 #define JSON_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "types.h"
+#include "column_projection.h"
+
+/**
+ * A single key/value pair from a parsed JSON object.
+ * Both views point into the line that was parsed, so they are only valid
+ * while that buffer is alive and unchanged.
+ */
+struct JsonFieldView {
+    std::string_view key;
+    std::string_view value;
+};
+
+/**
+ * Reusable output of JsonParser::parseJsonLineViews.
+ *
+ * Fields of every object on a line are stored contiguously and each object
+ * is a [begin, end) range into that array. parseJsonLineViews() clears the
+ * contents but keeps capacity, so one instance per reader parses any number
+ * of lines without allocating.
+ */
+class JsonLineViews {
+public:
+    struct Object {
+        const JsonFieldView* first;
+        const JsonFieldView* last;
+
+        const JsonFieldView* begin() const { return first; }
+        const JsonFieldView* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    void clear() {
+        fields.clear();
+        bounds.clear();
+    }
+
+    size_t size() const { return bounds.size(); }
+    bool empty() const { return bounds.empty(); }
+
+    Object operator[](size_t i) const {
+        const JsonFieldView* base = fields.data();
+        return {base + bounds[i].first, base + bounds[i].second};
+    }
+
+private:
+    friend class JsonParser;
+    std::vector<JsonFieldView> fields;
+    std::vector<std::pair<size_t, size_t>> bounds;  // [begin, end) into fields
+};
 
 class JsonParser {
 public:
     // Parse a line of JSON - handles single objects, arrays, or line-delimited objects
     static ReadingList parseJsonLine(const std::string& line);
+
+    /**
+     * Zero-copy variant of parseJsonLine().
+     * Fills `out` with views into `line`; nothing is allocated once `out`
+     * has grown to fit the widest line. Objects with no fields are omitted,
+     * matching parseJsonLine().
+     */
+    static void parseJsonLineViews(std::string_view line, JsonLineViews& out);
+
+    /**
+     * Materialize one parsed object into a Reading.
+     * If a key occurs more than once the first value wins, as with parseJsonLine().
+     */
+    static void toReading(const JsonLineViews::Object& object, Reading& reading);
+    
+    // As above, but only with the fields columns keeps; the rest are never interned or copied
+    static void toReading(const JsonLineViews::Object& object, Reading& reading, const ColumnProjection& columns);
 };
 
 #endif // JSON_PARSER_H
@@ -0,0 +1,94 @@
+#ifndef NUMERIC_UTILS_H
+#define NUMERIC_UTILS_H
+
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+// Converting reading values to numbers
+namespace NumericUtils {
+    /**
+     * Read a number from the start of str as std::stod does: leading
+     * whitespace, an optional sign, decimal or exponent notation, hex
+     * ("0x1p4"), "inf"/"infinity" and "nan". Sets used to the length of
+     * what was read. nullopt where stod throws: str doesn't start with a
+     * number, or it is out of double's range. Never throws and ignores the
+     * locale.
+     */
+    inline std::optional<double> scanDouble(std::string_view str, size_t& used) {
+        const char* begin = str.data();
+        size_t i = 0;
+        while (i < str.size() && (str[i] == ' ' || (str[i] >= '\t' && str[i] <= '\r'))) ++i;
+        str.remove_prefix(i);
+
+        // from_chars takes a minus sign but neither a plus nor a hex prefix
+        bool negative = false;
+        if (!str.empty() && (str[0] == '+' || str[0] == '-')) {
+            negative = str[0] == '-';
+            str.remove_prefix(1);
+            if (str.empty() || str[0] == '+' || str[0] == '-') return std::nullopt;
+        }
+
+        double value = 0.0;
+        const char* end = str.data() + str.size();
+        std::from_chars_result result{str.data(), std::errc::invalid_argument};
+        if (str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+            if (str[2] != '+' && str[2] != '-') {
+                result = std::from_chars(str.data() + 2, end, value, std::chars_format::hex);
+            }
+            // Without hex digits after it, stod reads the "0" alone
+            if (result.ec == std::errc::invalid_argument) result = {str.data() + 1, std::errc()};
+        } else {
+            result = std::from_chars(str.data(), end, value, std::chars_format::general);
+        }
+        if (result.ec != std::errc()) return std::nullopt;
+        used = static_cast<size_t>(result.ptr - begin);
+        return negative ? -value : value;
+    }
+
+    /**
+     * Parse a whole string as a finite double, or nullopt if it isn't one.
+     *
+     * Accepts what std::stod accepts when it consumes the whole string,
+     * except "inf"/"infinity" and "nan", which would poison sums and can't
+     * be sorted. Unlike stod it never throws and ignores the locale ("22.5"
+     * is 22.5 whatever LC_NUMERIC says), so "null", "" and "85C" cost no
+     * more to reject than a number does to accept.
+     */
+    inline std::optional<double> parseDouble(std::string_view str) {
+        size_t used = 0;
+        auto value = scanDouble(str, used);
+        if (!value || used != str.size() || !std::isfinite(*value)) return std::nullopt;
+        return value;
+    }
+
+    /**
+     * Read the number a string starts with, ignoring what follows ("85C"
+     * is 85), exactly as std::stod does; nullopt where stod throws.
+     */
+    inline std::optional<double> parseDoublePrefix(std::string_view str) {
+        size_t used = 0;
+        return scanDouble(str, used);
+    }
+
+    /**
+     * Parse a whole string as a number and truncate it toward zero, for
+     * timestamps; nullopt if it isn't a number or doesn't fit a long long.
+     * Plain integers are read exactly, however many digits they have.
+     */
+    inline std::optional<long long> parseInteger(std::string_view str) {
+        long long integer = 0;
+        const char* end = str.data() + str.size();
+        auto [ptr, ec] = std::from_chars(str.data(), end, integer);
+        if (ec == std::errc() && ptr == end) return integer;
+
+        auto value = parseDouble(str);
+        // 2^63 is exactly representable, so this keeps the cast defined
+        if (!value || !(std::fabs(*value) < 9223372036854775808.0)) return std::nullopt;
+        return static_cast<long long>(*value);
+    }
+}
+
+#endif // NUMERIC_UTILS_H
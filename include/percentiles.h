@@ -0,0 +1,53 @@
+#ifndef PERCENTILES_H
+#define PERCENTILES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Quartiles and other percentiles of exact-mode columns
+namespace Percentiles {
+    /**
+     * Percentiles (0-100) of unsorted values, each the same as
+     * StatsAnalyser::calculatePercentile gives on the sorted values, found
+     * with nth_element instead of a full sort; 0 for no values. Reorders
+     * values.
+     */
+    inline std::vector<double> select(std::vector<double>& values, const std::vector<double>& percentiles) {
+        std::vector<double> results;
+        size_t n = values.size();
+
+        // Ranks already in their sorted place, ascending. Everything between two
+        // of them is already on the right side of both, so each selection only
+        // has to partition the stretch between its neighbours.
+        std::vector<size_t> placed;
+        auto valueAt = [&](size_t rank) {
+            auto it = std::lower_bound(placed.begin(), placed.end(), rank);
+            if (it != placed.end() && *it == rank) return values[rank];
+            size_t from = (it == placed.begin()) ? 0 : *(it - 1) + 1;
+            size_t to = (it == placed.end()) ? n : *it;
+            std::nth_element(values.begin() + from, values.begin() + rank, values.begin() + to);
+            placed.insert(it, rank);
+            return values[rank];
+        };
+
+        for (double percentile : percentiles) {
+            if (n == 0) {
+                results.push_back(0.0);
+                continue;
+            }
+            // Same interpolation as calculatePercentile
+            double index = (percentile / 100.0) * (n - 1);
+            size_t lower = static_cast<size_t>(index);
+            double below = valueAt(lower);
+            if (lower + 1 >= n) {
+                results.push_back(below);
+                continue;
+            }
+            results.push_back(below + (index - lower) * (valueAt(lower + 1) - below));
+        }
+        return results;
+    }
+}
+
+#endif // PERCENTILES_H
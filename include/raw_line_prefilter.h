@@ -0,0 +1,85 @@
+#ifndef RAW_LINE_PREFILTER_H
+#define RAW_LINE_PREFILTER_H
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * RawLinePrefilter - rejects input lines that cannot pass the value filters,
+ * before they are parsed.
+ *
+ * Each group lists the values one column is allowed to have (--only-value,
+ * --allowed-values); a row passes only if, for every group, its column holds
+ * one of them. Parsed values are byte-for-byte substrings of their line
+ * (JSON values are kept raw), so a line containing none of a group's values
+ * can be skipped. Lines that contain a value may still fail; they are parsed
+ * and filtered as usual. CSV lines with a quote, or a carriage return
+ * before their last byte, are always parsed: the parser drops both, even in
+ * the middle of a field (s"1"x reads as s1x), so their values needn't
+ * appear in the raw line.
+ *
+ * Groups with a value that is empty or contains a quote or line break can't
+ * be decided this way and are left out. Move-only: the searchers point
+ * into the stored values, which a move leaves in place.
+ */
+class RawLinePrefilter {
+public:
+    RawLinePrefilter() = default;
+    RawLinePrefilter(const RawLinePrefilter&) = delete;
+    RawLinePrefilter& operator=(const RawLinePrefilter&) = delete;
+    RawLinePrefilter(RawLinePrefilter&&) = default;
+    RawLinePrefilter& operator=(RawLinePrefilter&&) = default;
+
+    // Require at least one of values to occur in a line
+    void require(const std::vector<std::string>& values) {
+        if (values.empty()) return;
+        for (const auto& value : values) {
+            if (value.empty() || value.find_first_of("\"\r\n") != std::string::npos) return;
+        }
+        Group group;
+        for (const auto& value : values) {
+            const std::string& stored = literals.emplace_back(value);
+            group.push_back(Searcher(stored.begin(), stored.end()));
+        }
+        groups.push_back(std::move(group));
+    }
+
+    void clear() {
+        groups.clear();
+        literals.clear();
+    }
+
+    bool active() const { return !groups.empty(); }
+
+    // False only if line cannot hold a row that passes the value filters
+    bool mayMatch(std::string_view line) const {
+        for (const auto& group : groups) {
+            bool found = std::any_of(group.begin(), group.end(), [line](const Searcher& searcher) {
+                return std::search(line.begin(), line.end(), searcher) != line.end();
+            });
+            if (!found) return false;
+        }
+        return true;
+    }
+
+    // CSV lines can only be judged raw if the parser drops nothing from
+    // them: no quotes, and no carriage return but a CRLF line ending's
+    static bool isPlainCsvLine(std::string_view line) {
+        if (line.find('"') != std::string_view::npos) return false;
+        size_t cr = line.find('\r');
+        return cr == std::string_view::npos || cr + 1 == line.size();
+    }
+
+private:
+    using Searcher = std::boyer_moore_horspool_searcher<std::string::const_iterator>;
+    using Group = std::vector<Searcher>;
+
+    std::deque<std::string> literals;  // deque: elements never move
+    std::vector<Group> groups;
+};
+
+#endif // RAW_LINE_PREFILTER_H
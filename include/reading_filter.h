@@ -8,12 +8,16 @@
 #include <vector>
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <iostream>
 #include <functional>
-#include <mutex>
 #include <memory>
 
 #include "types.h"
+#include "fingerprint.h"
+#include "seen_row_set.h"
+#include "raw_line_prefilter.h"
+#include "column_projection.h"
 #include "date_utils.h"
 #include "error_detector.h"
 
@@ -25,9 +29,9 @@
  * If onlyWhenEmpty is true, only update if targetColumn is missing or empty.
  */
 struct UpdateRule {
-    std::string matchColumn;
+    FieldKey matchColumn;
     std::string matchValue;
-    std::string targetColumn;
+    FieldKey targetColumn;
     std::string newValue;
     bool onlyWhenEmpty;  // --update-where-empty sets this to true
     
@@ -56,14 +60,15 @@ private:
     // Error filtering
     bool removeErrors;
     
-    // Empty/null filtering
-    std::set<std::string> notEmptyColumns;
-    std::set<std::string> notNullColumns;
+    // Empty/null filtering. Columns are held as interned keys so the
+    // per-row lookups compare IDs rather than hashing names.
+    std::set<FieldKey> notEmptyColumns;
+    std::set<FieldKey> notNullColumns;
     
     // Value-based filtering
-    std::map<std::string, std::set<std::string>> onlyValueFilters;
-    std::map<std::string, std::set<std::string>> excludeValueFilters;
-    std::map<std::string, std::set<std::string>> allowedValues;
+    std::map<FieldKey, std::set<std::string>> onlyValueFilters;
+    std::map<FieldKey, std::set<std::string>> excludeValueFilters;
+    std::map<FieldKey, std::set<std::string>> allowedValues;
     
     // Value updates (transformations applied after filtering)
     std::vector<UpdateRule> updateRules;
@@ -71,30 +76,163 @@ private:
     // Invert mode (for list-rejects command)
     bool invertFilter;
     
-    // Unique row filtering
+    // Unique row filtering: rows are remembered by fingerprint, or as full
+    // serialized rows when exactUnique is set (--unique-exact)
     bool uniqueRows;
-    mutable std::unordered_set<std::string> seenRows;  // mutable for const shouldInclude
-    mutable std::unique_ptr<std::mutex> seenRowsMutex;  // protects seenRows for thread safety
+    bool exactUnique;
+    mutable SeenRowSet seenRows;  // mutable for const shouldInclude; sharded locks for thread safety
     
     // Debug output
     int verbosity;
     
     /**
-     * Serialize a reading to a string for uniqueness checking.
+     * The filters above compiled into a flat list of checks, rebuilt by
+     * every setter so the per-row path never walks the configuration maps.
+     * Steps are ordered by cost: single-column presence checks, then value
+     * lists (include lists first, as they usually reject the most), then
+     * the date range, which parses a timestamp, then error detection.
+     */
+    struct FilterStep {
+        enum Kind { NotEmpty, NotNull, OnlyValue, AllowedValue, ExcludeValue, DateRange, Error };
+        Kind kind;
+        FieldKey column;
+        size_t valueSet;  // index into planValueSets for value-list steps
+    };
+    std::vector<FilterStep> plan;
+    std::vector<std::unordered_set<std::string>> planValueSets;
+    long long dateLow;   // inclusive bounds of the date range, open ends
+    long long dateHigh;  // widened to the full range of long long
+    RawLinePrefilter prefilter;  // the value lists, for lines not yet parsed
+    
+    void compilePlan() {
+        plan.clear();
+        planValueSets.clear();
+        for (const auto& col : notEmptyColumns) {
+            plan.push_back({FilterStep::NotEmpty, col, 0});
+        }
+        for (const auto& col : notNullColumns) {
+            plan.push_back({FilterStep::NotNull, col, 0});
+        }
+        auto addValueSteps = [this](FilterStep::Kind kind, const std::map<FieldKey, std::set<std::string>>& filters) {
+            for (const auto& [col, values] : filters) {
+                planValueSets.emplace_back(values.begin(), values.end());
+                plan.push_back({kind, col, planValueSets.size() - 1});
+            }
+        };
+        addValueSteps(FilterStep::OnlyValue, onlyValueFilters);
+        addValueSteps(FilterStep::AllowedValue, allowedValues);
+        addValueSteps(FilterStep::ExcludeValue, excludeValueFilters);
+        
+        prefilter.clear();
+        for (const auto* filters : {&onlyValueFilters, &allowedValues}) {
+            for (const auto& [col, values] : *filters) {
+                prefilter.require(std::vector<std::string>(values.begin(), values.end()));
+            }
+        }
+        
+        dateLow = minDate > 0 ? minDate : std::numeric_limits<long long>::min();
+        dateHigh = maxDate > 0 ? maxDate : std::numeric_limits<long long>::max();
+        if (minDate > 0 || maxDate > 0) {
+            plan.push_back({FilterStep::DateRange, Keys::Timestamp, 0});
+        }
+        if (removeErrors) {
+            plan.push_back({FilterStep::Error, FieldKey(), 0});
+        }
+    }
+    
+    // Date range check on a parsed timestamp; 0 means the row has none
+    bool inDateRange(long long timestamp) const {
+        return timestamp != 0 && timestamp >= dateLow && timestamp <= dateHigh;
+    }
+    
+    bool passesStep(const FilterStep& step, const Reading& reading) const {
+        switch (step.kind) {
+            case FilterStep::NotEmpty: {
+                auto it = reading.find(step.column);
+                return it != reading.end() && !it->second.empty();
+            }
+            case FilterStep::NotNull: {
+                auto it = reading.find(step.column);
+                if (it == reading.end()) return true;
+                const std::string& val = it->second;
+                return val != "null" && memchr(val.data(), '\0', val.size()) == nullptr;
+            }
+            case FilterStep::OnlyValue:
+            case FilterStep::AllowedValue: {
+                auto it = reading.find(step.column);
+                return it != reading.end() && planValueSets[step.valueSet].count(it->second) > 0;
+            }
+            case FilterStep::ExcludeValue: {
+                auto it = reading.find(step.column);
+                return it == reading.end() || planValueSets[step.valueSet].count(it->second) == 0;
+            }
+            case FilterStep::DateRange:
+                return inDateRange(DateUtils::getTimestamp(reading));
+            case FilterStep::Error:
+                return !ErrorDetector::isErrorReading(reading);
+        }
+        return true;
+    }
+    
+    // -V output for a row rejected by step
+    static void explainRejection(const FilterStep& step, const Reading& reading) {
+        auto it = reading.find(step.column);
+        bool missing = (it == reading.end());
+        switch (step.kind) {
+            case FilterStep::NotEmpty:
+                std::cerr << "  Skipping row: " << (missing ? "missing column '" : "empty column '")
+                          << step.column << "'" << std::endl;
+                break;
+            case FilterStep::NotNull:
+                std::cerr << "  Skipping row: null value in column '" << step.column << "'" << std::endl;
+                break;
+            case FilterStep::OnlyValue:
+            case FilterStep::AllowedValue:
+                if (missing) {
+                    std::cerr << "  Skipping row: missing column '" << step.column << "'" << std::endl;
+                } else if (step.kind == FilterStep::OnlyValue) {
+                    std::cerr << "  Skipping row: column '" << step.column << "' has value '"
+                              << it->second << "' (not in allowed values)" << std::endl;
+                } else {
+                    std::cerr << "  Skipping row: column '" << step.column << "' value '"
+                              << it->second << "' not in allowed values" << std::endl;
+                }
+                break;
+            case FilterStep::ExcludeValue:
+                std::cerr << "  Skipping row: column '" << step.column << "' has excluded value '"
+                          << it->second << "'" << std::endl;
+                break;
+            case FilterStep::DateRange:
+                std::cerr << "  Skipping row: outside date range" << std::endl;
+                break;
+            case FilterStep::Error:
+                std::cerr << "  Skipping error reading: " << ErrorDetector::getErrorDescription(reading) << std::endl;
+                break;
+        }
+    }
+    
+    /**
+     * Serialize a reading to a string for exact uniqueness checking.
      * Uses all key-value pairs in sorted order for consistent comparison.
      */
     static std::string serializeReading(const Reading& reading) {
         // Sort keys for consistent ordering
-        std::vector<std::pair<std::string, std::string>> pairs(reading.begin(), reading.end());
-        std::sort(pairs.begin(), pairs.end());
+        std::vector<const Reading::value_type*> pairs;
+        pairs.reserve(reading.size());
+        for (const auto& field : reading) {
+            pairs.push_back(&field);
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const Reading::value_type* a, const Reading::value_type* b) {
+            return a->first < b->first;
+        });
         std::string result;
         bool first = true;
-        for (const auto& [key, value] : pairs) {
+        for (const auto* field : pairs) {
             if (!first) result += '\x1f';  // unit separator
             first = false;
-            result += key;
+            result += field->first.str();
             result += '\x1e';  // record separator
-            result += value;
+            result += field->second;
         }
         return result;
     }
@@ -106,17 +244,21 @@ public:
         , removeErrors(false)
         , invertFilter(false)
         , uniqueRows(false)
-        , seenRowsMutex(std::make_unique<std::mutex>())
-        , verbosity(0) {}
+        , exactUnique(false)
+        , verbosity(0) {
+        compilePlan();
+    }
     
     // Setters for filter configuration
     void setDateRange(long long min, long long max) {
         minDate = min;
         maxDate = max;
+        compilePlan();
     }
     
     void setRemoveErrors(bool remove) {
         removeErrors = remove;
+        compilePlan();
     }
     
     void setVerbosity(int v) {
@@ -125,43 +267,53 @@ public:
     
     void addNotEmptyColumn(const std::string& col) {
         notEmptyColumns.insert(col);
+        compilePlan();
     }
     
     void addNotNullColumn(const std::string& col) {
         notNullColumns.insert(col);
+        compilePlan();
     }
     
     void addOnlyValueFilter(const std::string& col, const std::string& value) {
         onlyValueFilters[col].insert(value);
+        compilePlan();
     }
     
     void addExcludeValueFilter(const std::string& col, const std::string& value) {
         excludeValueFilters[col].insert(value);
+        compilePlan();
     }
     
     void addAllowedValue(const std::string& col, const std::string& value) {
         allowedValues[col].insert(value);
+        compilePlan();
     }
     
     // Bulk setters
     void setNotEmptyColumns(const std::set<std::string>& cols) {
-        notEmptyColumns = cols;
+        notEmptyColumns = std::set<FieldKey>(cols.begin(), cols.end());
+        compilePlan();
     }
     
     void setNotNullColumns(const std::set<std::string>& cols) {
-        notNullColumns = cols;
+        notNullColumns = std::set<FieldKey>(cols.begin(), cols.end());
+        compilePlan();
     }
     
     void setOnlyValueFilters(const std::map<std::string, std::set<std::string>>& filters) {
-        onlyValueFilters = filters;
+        onlyValueFilters = std::map<FieldKey, std::set<std::string>>(filters.begin(), filters.end());
+        compilePlan();
     }
     
     void setExcludeValueFilters(const std::map<std::string, std::set<std::string>>& filters) {
-        excludeValueFilters = filters;
+        excludeValueFilters = std::map<FieldKey, std::set<std::string>>(filters.begin(), filters.end());
+        compilePlan();
     }
     
     void setAllowedValues(const std::map<std::string, std::set<std::string>>& values) {
-        allowedValues = values;
+        allowedValues = std::map<FieldKey, std::set<std::string>>(values.begin(), values.end());
+        compilePlan();
     }
     
     void setInvertFilter(bool invert) {
@@ -172,6 +324,15 @@ public:
         uniqueRows = unique;
     }
     
+    void setExactUnique(bool exact) {
+        exactUnique = exact;
+    }
+    
+    // --unique-memory: cap on the seen-row set, in bytes (0 = no cap)
+    void setUniqueMemoryLimit(size_t bytes) {
+        seenRows.setMemoryLimit(bytes);
+    }
+    
     void clearSeenRows() {
         seenRows.clear();
     }
@@ -220,103 +381,116 @@ public:
      */
     bool passesDateFilter(const Reading& reading) const {
         if (minDate <= 0 && maxDate <= 0) return true;
-        long long timestamp = DateUtils::getTimestamp(reading);
-        return DateUtils::isInDateRange(timestamp, minDate, maxDate);
+        return inDateRange(DateUtils::getTimestamp(reading));
     }
     
     /**
      * Internal check - does reading pass all filter criteria?
+     * Runs the compiled plan; -V reasons are only worked out on rejection.
      */
     bool passesAllFilters(const Reading& reading) const {
-        // Check date range
-        if (!passesDateFilter(reading)) {
-            if (verbosity >= 2) {
-                std::cerr << "  Skipping row: outside date range" << std::endl;
-            }
-            return false;
-        }
-        
-        // Check if any required columns are empty
-        for (const auto& reqCol : notEmptyColumns) {
-            auto it = reading.find(reqCol);
-            if (it == reading.end() || it->second.empty()) {
+        for (const auto& step : plan) {
+            if (!passesStep(step, reading)) {
                 if (verbosity >= 2) {
-                    std::cerr << "  Skipping row: " 
-                             << (it == reading.end() ? "missing column '" : "empty column '") 
-                             << reqCol << "'" << std::endl;
+                    explainRejection(step, reading);
                 }
                 return false;
             }
         }
-        
-        // Check if any required columns contain null values
-        for (const auto& reqCol : notNullColumns) {
-            auto it = reading.find(reqCol);
-            if (it != reading.end()) {
-                const std::string& val = it->second;
-                bool hasNullChar = (memchr(val.data(), '\0', val.size()) != nullptr);
-                if (val == "null" || hasNullChar) {
-                    if (verbosity >= 2) {
-                        std::cerr << "  Skipping row: null value in column '" << reqCol << "'" << std::endl;
-                    }
-                    return false;
-                }
-            }
+        return true;
+    }
+    
+    /**
+     * Byte-level check DataReader may run on a raw line before parsing it,
+     * or nullptr if it must not: without value lists, when rejected rows are
+     * wanted (invertFilter), or at -V, where each rejection is reported.
+     */
+    const RawLinePrefilter* rawLinePrefilter() const {
+        if (invertFilter || verbosity >= 2 || !prefilter.active()) return nullptr;
+        return &prefilter;
+    }
+    
+    /**
+     * Add the columns the filters and update rules read to a reader's
+     * projection. --unique fingerprints whole rows, so it keeps them all.
+     */
+    void addCheckedColumns(ColumnProjection& columns) const {
+        if (uniqueRows) {
+            columns.keepAll();
+            return;
         }
-        
-        // Check value filters (include only)
-        for (const auto& [colName, allowedVals] : onlyValueFilters) {
-            auto it = reading.find(colName);
-            if (it == reading.end() || allowedVals.count(it->second) == 0) {
-                if (verbosity >= 2) {
-                    if (it == reading.end()) {
-                        std::cerr << "  Skipping row: missing column '" << colName << "'" << std::endl;
-                    } else {
-                        std::cerr << "  Skipping row: column '" << colName << "' has value '" 
-                                 << it->second << "' (not in allowed values)" << std::endl;
-                    }
-                }
-                return false;
+        for (const auto& step : plan) {
+            if (step.kind == FilterStep::Error) {
+                for (const auto& column : ErrorDetector::getCheckedColumns()) columns.add(column);
+            } else {
+                columns.add(step.column);
             }
         }
-        
-        // Check value filters (exclude)
-        for (const auto& [colName, excludedVals] : excludeValueFilters) {
-            auto it = reading.find(colName);
-            if (it != reading.end() && excludedVals.count(it->second) > 0) {
-                if (verbosity >= 2) {
-                    std::cerr << "  Skipping row: column '" << colName << "' has excluded value '" 
-                             << it->second << "'" << std::endl;
-                }
-                return false;
-            }
+        for (const auto& rule : updateRules) {
+            columns.add(rule.matchColumn);
+            columns.add(rule.targetColumn);
         }
-        
-        // Check allowed values filters
-        for (const auto& [colName, allowedVals] : allowedValues) {
-            auto it = reading.find(colName);
-            if (it == reading.end() || allowedVals.count(it->second) == 0) {
-                if (verbosity >= 2) {
-                    if (it == reading.end()) {
-                        std::cerr << "  Skipping row: missing column '" << colName << "'" << std::endl;
-                    } else {
-                        std::cerr << "  Skipping row: column '" << colName << "' value '" 
-                                 << it->second << "' not in allowed values" << std::endl;
-                    }
-                }
-                return false;
-            }
+    }
+    
+    /**
+     * Filter decision without the --unique check, honouring invertFilter.
+     * Safe to call from several threads at once.
+     */
+    bool matches(const Reading& reading) const {
+        bool passes = passesAllFilters(reading);
+        return invertFilter ? !passes : passes;
+    }
+    
+    /**
+     * --unique check: true the first time a reading is seen, false for
+     * every later duplicate. Always true when uniqueRows is off.
+     */
+    bool isFirstOccurrence(const Reading& reading) const {
+        if (!uniqueRows) return true;
+        return claimUniqueKey(uniqueKey(reading));
+    }
+    
+    bool isUniqueRows() const {
+        return uniqueRows;
+    }
+    
+    /**
+     * What --unique remembers about a reading: its fingerprint, and in
+     * exact mode also the full serialized row.
+     */
+    struct UniqueKey {
+        Fingerprint fingerprint;
+        std::string row;
+    };
+    
+    /**
+     * Key identifying a reading for --unique. Lets callers compute keys on
+     * worker threads and claim them later, in input order, on one thread.
+     */
+    UniqueKey uniqueKey(const Reading& reading) const {
+        UniqueKey key;
+        key.fingerprint = Fingerprint::of(reading);  // also picks the shard in exact mode
+        if (exactUnique) {
+            key.row = serializeReading(reading);
         }
-        
-        // Check for error readings
-        if (removeErrors && ErrorDetector::isErrorReading(reading)) {
+        return key;
+    }
+    
+    /**
+     * Record a key from uniqueKey(); true if it had not been seen before.
+     * Safe to call from several threads at once; which of two concurrent
+     * duplicates wins is unspecified, so callers that need the first one in
+     * input order claim keys in that order.
+     */
+    bool claimUniqueKey(UniqueKey key) const {
+        bool inserted = exactUnique ? seenRows.insert(key.fingerprint, std::move(key.row))
+                                    : seenRows.insert(key.fingerprint);
+        if (!inserted) {
             if (verbosity >= 2) {
-                std::string errorDesc = ErrorDetector::getErrorDescription(reading);
-                std::cerr << "  Skipping error reading: " << errorDesc << std::endl;
+                std::cerr << "  Skipping row: duplicate" << std::endl;
             }
             return false;
         }
-        
         return true;
     }
     
@@ -327,23 +501,8 @@ public:
      * If uniqueRows is true, only returns the first occurrence of each unique reading.
      */
     bool shouldInclude(const Reading& reading) const {
-        bool passes = passesAllFilters(reading);
-        bool result = invertFilter ? !passes : passes;
-        
-        // Check uniqueness if enabled and reading passes other filters
-        if (result && uniqueRows) {
-            std::string serialized = serializeReading(reading);
-            std::lock_guard<std::mutex> lock(*seenRowsMutex);
-            if (seenRows.count(serialized) > 0) {
-                if (verbosity >= 2) {
-                    std::cerr << "  Skipping row: duplicate" << std::endl;
-                }
-                return false;
-            }
-            seenRows.insert(serialized);
-        }
-        
-        return result;
+        // Check uniqueness only if the reading passes the other filters
+        return matches(reading) && isFirstOccurrence(reading);
     }
 };
 
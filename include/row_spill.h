@@ -0,0 +1,88 @@
+#ifndef ROW_SPILL_H
+#define ROW_SPILL_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "scratch_file.h"
+#include "types.h"
+
+/**
+ * RowSpill - rows parked in a temporary file until they can be written.
+ *
+ * CSV output needs the full column set before the first row, so a
+ * single-pass transform spills filtered rows here while it discovers the
+ * columns, then writes the header and replays the rows under it.
+ *
+ * Rows are stored length-prefixed as interned FieldKey IDs and raw values,
+ * so replay does no parsing. IDs are only meaningful inside this process.
+ * The file is removed when the RowSpill is destroyed (on POSIX it is
+ * unlinked as soon as it is opened).
+ */
+class RowSpill {
+public:
+    RowSpill() : file(spill.stream()) {}
+
+    RowSpill(const RowSpill&) = delete;
+    RowSpill& operator=(const RowSpill&) = delete;
+
+    bool isOpen() const { return spill.isOpen(); }
+
+    // Rows are appended here, as written by encode()
+    std::ostream& stream() { return file; }
+
+    /**
+     * Append one row: field count, then (key ID, value length, value bytes)
+     * per field.
+     */
+    static void encode(const Reading& reading, std::ostream& out) {
+        writeU32(out, static_cast<uint32_t>(reading.size()));
+        for (const auto& [key, value] : reading) {
+            writeU32(out, key.id());
+            writeU32(out, static_cast<uint32_t>(value.size()));
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+    }
+
+    /**
+     * Read every spilled row back from the start, in the order written.
+     * Returns false if the spill could not be written or read back.
+     */
+    template<typename Callback>
+    bool replay(Callback callback) {
+        file.flush();
+        if (!file) return false;
+        file.seekg(0);
+
+        Reading reading;
+        std::string value;
+        uint32_t fieldCount;
+        while (readU32(fieldCount)) {
+            reading.clear();
+            for (uint32_t i = 0; i < fieldCount; ++i) {
+                uint32_t keyId, length;
+                if (!readU32(keyId) || !readU32(length)) return false;
+                value.resize(length);
+                if (!file.read(&value[0], length)) return false;
+                reading.emplace(FieldKey::fromId(keyId), value);
+            }
+            callback(reading);
+        }
+        return file.eof();
+    }
+
+private:
+    ScratchFile spill;
+    std::fstream& file;
+
+    static void writeU32(std::ostream& out, uint32_t n) {
+        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    }
+
+    bool readU32(uint32_t& n) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&n), sizeof(n)));
+    }
+};
+
+#endif // ROW_SPILL_H
@@ -0,0 +1,250 @@
+#ifndef SCHEMA_CACHE_H
+#define SCHEMA_CACHE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/**
+ * SchemaCache - remembers the column set of each input file between runs.
+ *
+ * Transform's column discovery parses every file just to learn its keys.
+ * Log files are append-only, so a file whose size and modification time
+ * have not changed still has the same keys; the cache lets pass 1 skip it.
+ *
+ * Entries are keyed by absolute path and by a signature of the options
+ * that decide which rows are kept (filters, updates, tail options), since
+ * those change the column set too. The cache is one tab-separated text
+ * file in the cache directory, rewritten atomically by save() through a
+ * temp file of its own, so runs sharing a directory never mix their writes
+ * (the last one to save wins).
+ */
+class SchemaCache {
+public:
+    // Identity of a file's contents as far as the cache is concerned
+    struct Stamp {
+        uintmax_t size = 0;
+        long long mtime = 0;
+        bool valid = false;
+    };
+
+    SchemaCache(const std::string& directory, const std::string& filterSignature)
+        : directory(directory), signature(hashSignature(filterSignature)), dirty(false) {}
+
+    static Stamp stampOf(const std::string& path) {
+        namespace fs = std::filesystem;
+        Stamp stamp;
+        std::error_code ec;
+        stamp.size = fs::file_size(path, ec);
+        if (ec) return stamp;
+        auto mtime = fs::last_write_time(path, ec);
+        if (ec) return stamp;
+        stamp.mtime = static_cast<long long>(mtime.time_since_epoch().count());
+        stamp.valid = true;
+        return stamp;
+    }
+
+    /**
+     * Read the cache file. A missing cache is not an error; unreadable
+     * lines are skipped.
+     */
+    void load() {
+        std::ifstream in(cacheFile());
+        std::string line;
+        while (std::getline(in, line)) {
+            std::vector<std::string> fields = splitLine(line);
+            if (fields.size() < 4) continue;
+            try {
+                Entry entry;
+                entry.stamp.size = std::stoull(fields[2]);
+                entry.stamp.mtime = std::stoll(fields[3]);
+                entry.stamp.valid = true;
+                entry.keys.insert(fields.begin() + 4, fields.end());
+                entries[entryKey(fields[0], fields[1])] = std::move(entry);
+            } catch (const std::exception&) {
+                continue;
+            }
+        }
+    }
+
+    /**
+     * Look up the keys recorded for path. Only hits if the file still has
+     * the recorded stamp. Safe to call from several threads at once.
+     */
+    bool lookup(const std::string& path, const Stamp& stamp, std::set<std::string>& keys) const {
+        if (!stamp.valid) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(entryKey(signature, absolutePath(path)));
+        if (it == entries.end()) return false;
+        const Stamp& cached = it->second.stamp;
+        if (cached.size != stamp.size || cached.mtime != stamp.mtime) return false;
+        keys = it->second.keys;
+        return true;
+    }
+
+    /**
+     * Record the keys of path, as parsed when it had the given stamp (taken
+     * before parsing, so a file that grows meanwhile is re-read next time).
+     */
+    void store(const std::string& path, const Stamp& stamp, const std::set<std::string>& keys) {
+        if (!stamp.valid) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = entries[entryKey(signature, absolutePath(path))];
+        entry.stamp = stamp;
+        entry.keys = keys;
+        dirty = true;
+    }
+
+    /**
+     * Write the cache back if anything was stored, leaving out files that
+     * no longer exist. Returns false on failure.
+     */
+    bool save() {
+        namespace fs = std::filesystem;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!dirty) return true;
+
+        for (auto it = entries.begin(); it != entries.end();) {
+            std::error_code unknown;  // keep entries that can't be checked
+            if (!fs::exists(it->first.substr(it->first.find('\t') + 1), unknown) && !unknown) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        std::string target = cacheFile();
+        std::string temp = createTempFile(target);
+        if (temp.empty()) return false;
+        {
+            std::ofstream out(temp);
+            if (!out) {
+                std::remove(temp.c_str());
+                return false;
+            }
+            for (const auto& [key, entry] : entries) {
+                size_t split = key.find('\t');
+                out << key.substr(0, split) << '\t' << escape(key.substr(split + 1))
+                    << '\t' << entry.stamp.size << '\t' << entry.stamp.mtime;
+                for (const auto& field : entry.keys) {
+                    out << '\t' << escape(field);
+                }
+                out << '\n';
+            }
+            if (!out) {
+                out.close();
+                std::remove(temp.c_str());
+                return false;
+            }
+        }
+        fs::rename(temp, target, ec);
+        if (ec) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        dirty = false;
+        return true;
+    }
+
+private:
+    struct Entry {
+        Stamp stamp;
+        std::set<std::string> keys;
+    };
+
+    std::string directory;
+    std::string signature;
+    std::map<std::string, Entry> entries;  // "signature\tpath" -> entry
+    mutable std::mutex mutex;
+    bool dirty;
+
+    std::string cacheFile() const {
+        return (std::filesystem::path(directory) / "schema-cache.tsv").string();
+    }
+
+    // Create an empty file named after target with a unique suffix; "" on failure
+    static std::string createTempFile(const std::string& target) {
+#if defined(_WIN32) || defined(_WIN64)
+        std::random_device random;
+        std::string path = target + "." + std::to_string(random()) + std::to_string(random());
+        std::ofstream out(path);
+        return out ? path : std::string();
+#else
+        std::string pattern = target + ".XXXXXX";
+        int fd = mkstemp(&pattern[0]);
+        if (fd < 0) return std::string();
+        ::close(fd);
+        return pattern;
+#endif
+    }
+
+    static std::string entryKey(const std::string& signature, const std::string& path) {
+        return signature + '\t' + path;
+    }
+
+    static std::string absolutePath(const std::string& path) {
+        std::error_code ec;
+        auto absolute = std::filesystem::absolute(path, ec);
+        return ec ? path : absolute.lexically_normal().string();
+    }
+
+    // FNV-1a, so signatures stay stable across builds and platforms
+    static std::string hashSignature(const std::string& text) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+        return hex;
+    }
+
+    // Paths and keys may contain tabs or newlines; keep each entry on one line
+    static std::string escape(const std::string& text) {
+        std::string result;
+        result.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '\\': result += "\\\\"; break;
+                case '\t': result += "\\t"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                default: result += c;
+            }
+        }
+        return result;
+    }
+
+    static std::vector<std::string> splitLine(const std::string& line) {
+        std::vector<std::string> fields(1);
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (c == '\t') {
+                fields.emplace_back();
+            } else if (c == '\\' && i + 1 < line.size()) {
+                char next = line[++i];
+                fields.back() += (next == 't') ? '\t' : (next == 'n') ? '\n' : (next == 'r') ? '\r' : next;
+            } else {
+                fields.back() += c;
+            }
+        }
+        return fields;
+    }
+};
+
+#endif // SCHEMA_CACHE_H
@@ -0,0 +1,63 @@
+#ifndef SCRATCH_FILE_H
+#define SCRATCH_FILE_H
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/**
+ * ScratchFile - an anonymous binary scratch file, open for reading and writing.
+ *
+ * Created in the system temp directory and removed when the ScratchFile is
+ * destroyed (on POSIX it is unlinked as soon as it is opened, so nothing is
+ * left behind even if the process is killed).
+ */
+class ScratchFile {
+public:
+    ScratchFile() {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::path dir = fs::temp_directory_path(ec);
+        if (ec) dir = ".";
+#if defined(_WIN32) || defined(_WIN64)
+        std::random_device random;
+        path = (dir / ("sensor-data-" + std::to_string(random()) + std::to_string(random()) + ".spill")).string();
+        file.open(path, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+#else
+        std::string pattern = (dir / "sensor-data-XXXXXX").string();
+        int fd = mkstemp(&pattern[0]);
+        if (fd >= 0) {
+            file.open(pattern, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+            ::close(fd);
+            std::remove(pattern.c_str());
+        }
+#endif
+    }
+
+    ~ScratchFile() {
+        file.close();
+        if (!path.empty()) {
+            std::remove(path.c_str());
+        }
+    }
+
+    ScratchFile(const ScratchFile&) = delete;
+    ScratchFile& operator=(const ScratchFile&) = delete;
+
+    bool isOpen() const { return file.is_open(); }
+
+    std::fstream& stream() { return file; }
+
+private:
+    std::fstream file;
+    std::string path;  // only set where the file can't be unlinked while open
+};
+
+#endif // SCRATCH_FILE_H
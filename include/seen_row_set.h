@@ -0,0 +1,106 @@
+#ifndef SEEN_ROW_SET_H
+#define SEEN_ROW_SET_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "fingerprint.h"
+#include "spilling_fingerprint_set.h"
+
+/**
+ * SeenRowSet - the rows --unique has already let through, shared by all
+ * threads reading with one ReadingFilter.
+ *
+ * Split into shards chosen by the top bits of the fingerprint, each with
+ * its own lock, so threads claiming different rows rarely wait on each
+ * other. A shard holds fingerprints, or the full serialized rows when the
+ * filter compares exactly (--unique-exact).
+ *
+ * With a memory limit (--unique-memory) fingerprints go to one
+ * SpillingFingerprintSet under a single lock instead, since its runs on
+ * disk can't be split across shards without multiplying open files.
+ */
+class SeenRowSet {
+public:
+    static constexpr size_t SHARD_BITS = 6;
+    static constexpr size_t SHARDS = size_t(1) << SHARD_BITS;
+
+    SeenRowSet() : shards(new Shard[SHARDS]) {}
+
+    /**
+     * Cap the memory used for fingerprints, in bytes; 0 means no cap. Call
+     * before the first insert. The Bloom filter is only allocated once
+     * fingerprints spill.
+     */
+    void setMemoryLimit(size_t bytes) {
+        bounded = bytes > 0 ? std::make_unique<Bounded>(bytes) : nullptr;
+    }
+
+    // True if fingerprint was not in the set yet
+    bool insert(const Fingerprint& fingerprint) {
+        if (bounded) {
+            std::lock_guard<std::mutex> lock(bounded->mutex);
+            return bounded->fingerprints.insert(fingerprint);
+        }
+        Shard& shard = shardFor(fingerprint);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.fingerprints.insert(fingerprint);
+    }
+
+    // Exact variant: row decides, fingerprint only picks the shard
+    bool insert(const Fingerprint& fingerprint, std::string row) {
+        Shard& shard = shardFor(fingerprint);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.rows.insert(std::move(row)).second;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < SHARDS; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].fingerprints.size() + shards[i].rows.size();
+        }
+        if (bounded) {
+            std::lock_guard<std::mutex> lock(bounded->mutex);
+            total += bounded->fingerprints.size();
+        }
+        return total;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < SHARDS; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            shards[i].fingerprints.clear();
+            shards[i].rows.clear();
+        }
+        if (bounded) {
+            std::lock_guard<std::mutex> lock(bounded->mutex);
+            bounded->fingerprints.clear();
+        }
+    }
+
+private:
+    // Own cache line each, so locking one shard doesn't slow its neighbours
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        FingerprintSet fingerprints;
+        std::unordered_set<std::string> rows;
+    };
+
+    struct Bounded {
+        explicit Bounded(size_t bytes) : fingerprints(bytes) {}
+        std::mutex mutex;
+        SpillingFingerprintSet fingerprints;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::unique_ptr<Bounded> bounded;  // set by setMemoryLimit()
+
+    Shard& shardFor(const Fingerprint& fingerprint) {
+        return shards[fingerprint.hi >> (64 - SHARD_BITS)];
+    }
+};
+
+#endif // SEEN_ROW_SET_H
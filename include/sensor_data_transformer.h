@@ -6,9 +6,12 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_set>
 #include <mutex>
+#include <memory>
 
 #include "command_base.h"
+#include "schema_cache.h"
 
 /**
  * SensorDataTransformer - Transform sensor data between JSON and CSV formats.
@@ -35,9 +38,17 @@ private:
     std::set<std::string> allKeys;
     std::mutex keysMutex;
     std::mutex outputMutex;  // Protect console output in multi-threaded operations
-    int numThreads;
     bool usePrototype;
     
+    // --schema-cache <dir>: per-file column sets kept between runs
+    std::string schemaCacheDir;
+    std::unique_ptr<SchemaCache> schemaCache;
+    
+    // --single-pass: CSV rows go to a RowSpill while columns are discovered
+    bool singlePass;
+    bool spillRows;
+    std::unordered_set<FieldKey> spilledKeys;
+    
     /**
      * Check if any filtering is active (affects whether we can pass-through JSON lines)
      */
@@ -53,6 +64,12 @@ private:
      */
     void collectKeysFromFile(const std::string& filename);
     
+    /**
+     * Options that decide which rows reach the output, and so which
+     * columns a file contributes; part of each schema cache entry's key
+     */
+    std::string schemaSignature() const;
+    
     /**
      * Second pass: write rows from a file directly to CSV
      */
@@ -66,17 +83,41 @@ private:
                                bool& firstOutput, DataReader& reader);
     
     /**
-     * Process collected readings and output as CSV
+     * Second pass for JSON/CSV: write the header (CSV) and all rows to outfile
+     */
+    void writeRows(std::ostream& outfile, const std::vector<std::string>& headers);
+    
+    /**
+     * Rows from every input file in file order, without header or trailer
+     */
+    void writeFileRows(std::ostream& outfile, const std::vector<std::string>& headers,
+                       bool& firstOutput);
+    
+    /**
+     * Append a row to the spill and note its columns
+     */
+    static void spillRow(const Reading& reading, std::ostream& spill,
+                         std::unordered_set<FieldKey>& keys);
+    
+    /**
+     * --single-pass: read each input once, spilling CSV rows until the
+     * column set is known (JSON output needs no column set)
+     */
+    void transformSinglePass();
+    
+    /**
+     * Second pass over many files: the file at the head of the output is
+     * written as it is read, and files ahead of it are formatted into
+     * memory, up to a limit, until their turn comes
      */
-    void processStdinData(const ReadingList& readings, 
-                          const std::vector<std::string>& headers, 
-                          std::ostream& outfile);
+    void writeFilesParallel(std::ostream& outfile, const std::vector<std::string>& headers,
+                            bool& firstOutput);
     
     /**
-     * Process collected readings and output as JSON array
+     * Transform stdin: JSON is streamed straight out, CSV rows go through
+     * a RowSpill so memory stays flat however much input arrives
      */
-    void processStdinDataJson(const ReadingList& readings, 
-                              std::ostream& outfile);
+    void transformStdin();
     
     /**
      * Write a single row (dispatches to CSV or JSON based on outputFormat)
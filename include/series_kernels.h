@@ -0,0 +1,238 @@
+#ifndef SERIES_KERNELS_H
+#define SERIES_KERNELS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+/**
+ * Fused reductions over a column of values for exact-mode stats.
+ *
+ * Everything the stats command reports about a column apart from its
+ * quartiles comes from two passes over the values in reading order: the
+ * first finds min, max and sum of the values and min, max (first one) and
+ * sum of the absolute differences between neighbours; the second, once the
+ * means are known, sums squared differences from them (the two-pass
+ * variance, which stays accurate when values are large compared to their
+ * spread) and counts values outside the outlier fences.
+ *
+ * The passes are written with GCC/Clang vector extensions, so they compile
+ * to SSE2 on x86-64 and NEON on 64-bit ARM. On x86 a second copy built for
+ * AVX2 is used when the CPU has it. Sums are taken a few lanes at a time,
+ * so they can differ from a one-by-one sum in the last bits.
+ */
+struct SeriesMoments {
+    size_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;       // sample (n - 1), 0 for fewer than two values
+    size_t deltaCount = 0;     // count - 1 differences between neighbours
+    double deltaMin = 0.0;
+    double deltaMax = 0.0;
+    double deltaMean = 0.0;
+    double deltaStddev = 0.0;  // 0 for fewer than two differences
+    size_t maxJumpIndex = 0;   // the first values[i] with |values[i] - values[i - 1]| == deltaMax
+    size_t outliers = 0;       // values below lowerFence or above upperFence
+};
+
+namespace SeriesKernels {
+    template <size_t Lanes>
+    struct Vec {
+        typedef double Real __attribute__((vector_size(Lanes * sizeof(double))));
+        typedef long long Mask __attribute__((vector_size(Lanes * sizeof(double))));
+    };
+
+#define SERIES_KERNEL_INLINE inline __attribute__((always_inline))
+
+    // The helpers take vectors by reference: passing 256-bit ones by value
+    // from code not built for AVX would change the calling convention
+
+    template <typename Real>
+    SERIES_KERNEL_INLINE void load(Real& v, const double* p) {
+        std::memcpy(&v, p, sizeof v);
+    }
+
+    template <typename Real>
+    SERIES_KERNEL_INLINE void broadcast(Real& v, double x) {
+        for (size_t i = 0; i < sizeof(Real) / sizeof(double); ++i) v[i] = x;
+    }
+
+    // Replace the lanes of v where mask is set with those of from
+    template <typename Real, typename Mask>
+    SERIES_KERNEL_INLINE void update(Real& v, const Mask& mask, const Real& from) {
+        v = (Real)((mask & (Mask)from) | (~mask & (Mask)v));
+    }
+
+    // |a - b| with the sign bit cleared
+    template <typename Real, typename Mask>
+    SERIES_KERNEL_INLINE void absoluteDifference(Real& v, const Real& a, const Real& b, const Mask& sign) {
+        v = (Real)((Mask)(a - b) & ~sign);
+    }
+
+    template <size_t Lanes>
+    SERIES_KERNEL_INLINE SeriesMoments moments(const double* values, size_t n,
+                                               double lowerFence, double upperFence) {
+        typedef typename Vec<Lanes>::Real Real;
+        typedef typename Vec<Lanes>::Mask Mask;
+
+        SeriesMoments m;
+        m.count = n;
+        if (n == 0) return m;
+        m.outliers = (values[0] < lowerFence || values[0] > upperFence) ? 1 : 0;
+
+        Real zero, negativeZero, step, index;
+        broadcast(zero, 0.0);
+        broadcast(negativeZero, -0.0);
+        const Mask sign = (Mask)negativeZero;  // just the sign bit of each lane
+        broadcast(step, static_cast<double>(Lanes));
+        for (size_t l = 0; l < Lanes; ++l) index[l] = static_cast<double>(1 + l);
+
+        // Pass 1: values[0] seeds the extremes and each step i takes values[i]
+        // and its difference from values[i - 1]
+        Real sum = zero, deltaSum = zero, jumpAt = zero;  // jumpAt: index of each lane's deltaHi
+        Real lo, hi, deltaLo, deltaHi;
+        broadcast(lo, values[0]);
+        hi = lo;
+        broadcast(deltaLo, std::numeric_limits<double>::infinity());
+        broadcast(deltaHi, -1.0);
+
+        size_t i = 1;
+        for (; i + Lanes <= n; i += Lanes) {
+            Real cur, prev, delta;
+            load(cur, values + i);
+            load(prev, values + i - 1);
+            absoluteDifference(delta, cur, prev, sign);
+            sum += cur;
+            update(lo, (Mask)(cur < lo), cur);
+            update(hi, (Mask)(cur > hi), cur);
+            deltaSum += delta;
+            update(deltaLo, (Mask)(delta < deltaLo), delta);
+            // Strictly greater, so each lane keeps its first largest jump
+            Mask further = (Mask)(delta > deltaHi);
+            update(deltaHi, further, delta);
+            update(jumpAt, further, index);
+            index += step;
+        }
+
+        double total = values[0];
+        double deltaTotal = 0.0;
+        m.min = lo[0];
+        m.max = hi[0];
+        m.deltaMin = deltaLo[0];
+        m.deltaMax = -1.0;
+        for (size_t l = 0; l < Lanes; ++l) {
+            total += sum[l];
+            if (lo[l] < m.min) m.min = lo[l];
+            if (hi[l] > m.max) m.max = hi[l];
+            deltaTotal += deltaSum[l];
+            if (deltaLo[l] < m.deltaMin) m.deltaMin = deltaLo[l];
+            size_t at = static_cast<size_t>(jumpAt[l]);
+            if (deltaHi[l] > m.deltaMax || (deltaHi[l] == m.deltaMax && at < m.maxJumpIndex)) {
+                m.deltaMax = deltaHi[l];
+                m.maxJumpIndex = at;
+            }
+        }
+        // The rest come after every lane's, so only a strictly larger jump wins
+        for (; i < n; ++i) {
+            double cur = values[i];
+            double delta = std::fabs(cur - values[i - 1]);
+            total += cur;
+            if (cur < m.min) m.min = cur;
+            if (cur > m.max) m.max = cur;
+            deltaTotal += delta;
+            if (delta < m.deltaMin) m.deltaMin = delta;
+            if (delta > m.deltaMax) {
+                m.deltaMax = delta;
+                m.maxJumpIndex = i;
+            }
+        }
+        m.mean = total / static_cast<double>(n);
+        if (n == 1) {
+            m.deltaMin = m.deltaMax = 0.0;
+            m.maxJumpIndex = 0;
+            return m;
+        }
+
+        m.deltaCount = n - 1;
+        m.deltaMean = deltaTotal / static_cast<double>(m.deltaCount);
+        if (m.maxJumpIndex == 0) {
+            // Every difference was NaN
+            m.maxJumpIndex = 1;
+            m.deltaMin = m.deltaMax = std::fabs(values[1] - values[0]);
+        }
+
+        // Pass 2: squared differences from the means, and the outliers
+        Real mean, deltaMean, lowerFences, upperFences;
+        broadcast(mean, m.mean);
+        broadcast(deltaMean, m.deltaMean);
+        broadcast(lowerFences, lowerFence);
+        broadcast(upperFences, upperFence);
+        Real squares = zero, deltaSquares = zero;
+        Mask outside = {};
+
+        for (i = 1; i + Lanes <= n; i += Lanes) {
+            Real cur, prev, delta;
+            load(cur, values + i);
+            load(prev, values + i - 1);
+            absoluteDifference(delta, cur, prev, sign);
+            Real spread = cur - mean;
+            Real deltaSpread = delta - deltaMean;
+            squares += spread * spread;
+            deltaSquares += deltaSpread * deltaSpread;
+            // A set mask lane is -1
+            outside -= (Mask)(cur < lowerFences) | (Mask)(cur > upperFences);
+        }
+
+        double first = values[0] - m.mean;
+        double squareTotal = first * first;
+        double deltaSquareTotal = 0.0;
+        for (size_t l = 0; l < Lanes; ++l) {
+            squareTotal += squares[l];
+            deltaSquareTotal += deltaSquares[l];
+            m.outliers += static_cast<size_t>(outside[l]);
+        }
+        for (; i < n; ++i) {
+            double spread = values[i] - m.mean;
+            double deltaSpread = std::fabs(values[i] - values[i - 1]) - m.deltaMean;
+            squareTotal += spread * spread;
+            deltaSquareTotal += deltaSpread * deltaSpread;
+            if (values[i] < lowerFence || values[i] > upperFence) m.outliers++;
+        }
+
+        m.stddev = std::sqrt(squareTotal / static_cast<double>(n - 1));
+        if (m.deltaCount > 1) {
+            m.deltaStddev = std::sqrt(deltaSquareTotal / static_cast<double>(m.deltaCount - 1));
+        }
+        return m;
+    }
+
+#undef SERIES_KERNEL_INLINE
+
+    // Two lanes: SSE2 on x86-64, NEON on AArch64, scalar code elsewhere
+    inline SeriesMoments moments128(const double* values, size_t n, double lowerFence, double upperFence) {
+        return moments<2>(values, n, lowerFence, upperFence);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    inline SeriesMoments momentsAvx2(const double* values, size_t n, double lowerFence, double upperFence) {
+        return moments<4>(values, n, lowerFence, upperFence);
+    }
+#endif
+
+    /**
+     * Moments of values[0..n) in reading order, with the outliers counted
+     * against the given fences, on the widest vectors the CPU has
+     */
+    inline SeriesMoments compute(const double* values, size_t n, double lowerFence, double upperFence) {
+#if defined(__x86_64__) || defined(__i386__)
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        if (avx2) return momentsAvx2(values, n, lowerFence, upperFence);
+#endif
+        return moments128(values, n, lowerFence, upperFence);
+    }
+}
+
+#endif // SERIES_KERNELS_H
@@ -0,0 +1,260 @@
+#ifndef SPILLING_FINGERPRINT_SET_H
+#define SPILLING_FINGERPRINT_SET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "fingerprint.h"
+#include "scratch_file.h"
+
+/**
+ * SpillingFingerprintSet - a fingerprint set that stays within a memory
+ * budget by moving fingerprints to disk (--unique-memory).
+ *
+ * New fingerprints go into an in-memory FingerprintSet. When that would
+ * outgrow its half of the budget it is sorted and written out as a run
+ * file, and runs are merged four at a time into larger ones as they pile
+ * up, so there are only a few per size tier. A lookup checks the table,
+ * then a Bloom filter (the other half of the budget) over everything
+ * spilled, and reads one block from each run only if the filter says the
+ * fingerprint may be there.
+ *
+ * Answers are exact, the same as an unbounded FingerprintSet: if a run
+ * can't be read back, insert() throws std::runtime_error rather than guess.
+ * Each run also keeps the first fingerprint of every block in memory, about
+ * 1/1024 of its size on disk. Not thread-safe.
+ */
+class SpillingFingerprintSet {
+public:
+    explicit SpillingFingerprintSet(size_t memoryBytes)
+        : tableBudget(std::max<size_t>(memoryBytes / 2, MIN_TABLE_BYTES))
+        , bloomBytes(std::max<size_t>(memoryBytes / 2, sizeof(uint64_t)))
+        , spilled(0)
+        , spillFailed(false) {}
+
+    // True if fp was not in the set yet
+    bool insert(Fingerprint fp) {
+        if (fp.lo == 0 && fp.hi == 0) fp.lo = 1;  // as FingerprintSet stores it
+        if (table.contains(fp)) return false;
+        if (!runs.empty() && bloomMayContain(fp) && runsContain(fp)) return false;
+        if (!spillFailed && table.memoryBytesAfterInsert() > tableBudget) {
+            spill();
+        }
+        table.insert(fp);
+        return true;
+    }
+
+    size_t size() const { return table.size() + spilled; }
+
+    size_t runCount() const { return runs.size(); }
+
+    void clear() {
+        table.clear();
+        runs.clear();
+        bloom.clear();
+        bloom.shrink_to_fit();
+        spilled = 0;
+    }
+
+private:
+    static constexpr size_t MIN_TABLE_BYTES = 64 * 1024;
+    static constexpr size_t BLOCK = 1024;  // fingerprints per run block
+    static constexpr size_t FANOUT = 4;    // runs of one tier merged at a time
+    static constexpr int BLOOM_HASHES = 3;
+
+    // A sorted file of fingerprints
+    struct Run {
+        std::unique_ptr<ScratchFile> file;
+        size_t count = 0;
+        int tier = 0;
+        std::vector<Fingerprint> fences;  // first fingerprint of each block
+    };
+
+    // Reads a run front to back, one block at a time
+    struct RunReader {
+        Run* run;
+        std::vector<Fingerprint> buffer;
+        size_t next = 0;     // index in the run of buffer[0]
+        size_t position = 0; // index in buffer
+
+        bool valid() const { return position < buffer.size(); }
+        const Fingerprint& head() const { return buffer[position]; }
+    };
+
+    FingerprintSet table;
+    size_t tableBudget;
+    size_t bloomBytes;
+    std::vector<uint64_t> bloom;  // allocated on the first spill
+    std::vector<std::unique_ptr<Run>> runs;
+    std::vector<Fingerprint> blockBuffer;
+    size_t spilled;
+    bool spillFailed;
+
+    static bool less(const Fingerprint& a, const Fingerprint& b) {
+        return a.hi != b.hi ? a.hi < b.hi : a.lo < b.lo;
+    }
+
+    // ----- Bloom filter -----
+
+    size_t bloomMask() const { return bloom.size() * 64 - 1; }
+
+    bool bloomMayContain(const Fingerprint& fp) const {
+        size_t mask = bloomMask();
+        for (int i = 0; i < BLOOM_HASHES; ++i) {
+            size_t bit = (fp.lo + i * (fp.hi | 1)) & mask;
+            if (!(bloom[bit / 64] & (uint64_t(1) << (bit % 64)))) return false;
+        }
+        return true;
+    }
+
+    void bloomAdd(const Fingerprint& fp) {
+        size_t mask = bloomMask();
+        for (int i = 0; i < BLOOM_HASHES; ++i) {
+            size_t bit = (fp.lo + i * (fp.hi | 1)) & mask;
+            bloom[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+    }
+
+    // ----- Runs -----
+
+    bool runsContain(const Fingerprint& fp) {
+        for (auto& run : runs) {
+            auto fence = std::upper_bound(run->fences.begin(), run->fences.end(), fp, less);
+            if (fence == run->fences.begin()) continue;
+            size_t block = static_cast<size_t>(fence - run->fences.begin()) - 1;
+            if (!readBlock(*run, block * BLOCK, blockBuffer)) {
+                throw std::runtime_error("--unique-memory could not read back rows spilled to the temp directory");
+            }
+            if (std::binary_search(blockBuffer.begin(), blockBuffer.end(), fp, less)) return true;
+        }
+        return false;
+    }
+
+    // Read up to one block of fingerprints starting at index first
+    static bool readBlock(Run& run, size_t first, std::vector<Fingerprint>& out) {
+        size_t n = std::min(BLOCK, run.count - first);
+        out.resize(n);
+        std::fstream& file = run.file->stream();
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(first * sizeof(Fingerprint)));
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()),
+                                           static_cast<std::streamsize>(n * sizeof(Fingerprint))));
+    }
+
+    // Start a run; fingerprints are then added in order with append()
+    static std::unique_ptr<Run> newRun(int tier) {
+        auto run = std::make_unique<Run>();
+        run->file = std::make_unique<ScratchFile>();
+        run->tier = tier;
+        return run;
+    }
+
+    static void append(Run& run, const Fingerprint& fp) {
+        if (run.count % BLOCK == 0) run.fences.push_back(fp);
+        run.file->stream().write(reinterpret_cast<const char*>(&fp), sizeof(fp));
+        ++run.count;
+    }
+
+    static bool finish(Run& run) {
+        return run.file->isOpen() && static_cast<bool>(run.file->stream().flush());
+    }
+
+    /**
+     * Move the in-memory table to a new run. If the disk can't take it, warn
+     * once and keep everything in memory from then on.
+     */
+    void spill() {
+        std::vector<Fingerprint> entries = table.release();
+        std::sort(entries.begin(), entries.end(), less);
+
+        auto run = newRun(0);
+        for (const auto& fp : entries) append(*run, fp);
+        if (!finish(*run)) {
+            std::cerr << "Warning: --unique-memory could not write to the temp directory, "
+                      << "keeping unique rows in memory" << std::endl;
+            spillFailed = true;
+            for (const auto& fp : entries) table.insert(fp);
+            return;
+        }
+
+        if (bloom.empty()) {
+            size_t words = 1;
+            while (words * 2 * sizeof(uint64_t) <= bloomBytes) words *= 2;
+            bloom.assign(words, 0);
+        }
+        for (const auto& fp : entries) bloomAdd(fp);
+        spilled += entries.size();
+        runs.push_back(std::move(run));
+        compact();
+    }
+
+    // Merge runs FANOUT at a time, smallest tier first
+    void compact() {
+        for (int tier = 0;; ++tier) {
+            std::vector<size_t> sameTier;
+            for (size_t i = 0; i < runs.size(); ++i) {
+                if (runs[i]->tier == tier) sameTier.push_back(i);
+            }
+            if (sameTier.size() < FANOUT) {
+                bool higher = std::any_of(runs.begin(), runs.end(),
+                                          [tier](const auto& run) { return run->tier > tier; });
+                if (!higher) return;
+                continue;
+            }
+            if (!merge(sameTier, tier + 1)) return;  // keep the runs as they are
+        }
+    }
+
+    bool merge(const std::vector<size_t>& indices, int tier) {
+        std::vector<RunReader> readers;
+        for (size_t i : indices) {
+            RunReader reader{runs[i].get(), {}, 0, 0};
+            if (!refill(reader)) return false;
+            readers.push_back(std::move(reader));
+        }
+
+        // Runs never share a fingerprint, so this is a plain k-way merge
+        auto merged = newRun(tier);
+        while (true) {
+            RunReader* smallest = nullptr;
+            for (auto& reader : readers) {
+                if (reader.valid() && (!smallest || less(reader.head(), smallest->head()))) {
+                    smallest = &reader;
+                }
+            }
+            if (!smallest) break;
+            append(*merged, smallest->head());
+            if (++smallest->position == smallest->buffer.size() && !refill(*smallest)) return false;
+        }
+        if (!finish(*merged)) return false;
+
+        std::vector<std::unique_ptr<Run>> kept;
+        for (size_t i = 0; i < runs.size(); ++i) {
+            if (std::find(indices.begin(), indices.end(), i) == indices.end()) {
+                kept.push_back(std::move(runs[i]));
+            }
+        }
+        kept.push_back(std::move(merged));
+        runs.swap(kept);
+        return true;
+    }
+
+    // Load the reader's next block; an exhausted run leaves it empty
+    static bool refill(RunReader& reader) {
+        reader.position = 0;
+        if (reader.next >= reader.run->count) {
+            reader.buffer.clear();
+            return true;
+        }
+        if (!readBlock(*reader.run, reader.next, reader.buffer)) return false;
+        reader.next += reader.buffer.size();
+        return true;
+    }
+};
+
+#endif // SPILLING_FINGERPRINT_SET_H
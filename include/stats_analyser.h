@@ -1,11 +1,16 @@
 #ifndef STATS_ANALYSER_H
 #define STATS_ANALYSER_H
 
+#include <chrono>
+#include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <map>
 
 #include "command_base.h"
+#include "date_utils.h"
+#include "streaming_stats.h"
 
 /**
  * StatsAnalyser - Calculate statistics for numeric sensor data.
@@ -15,14 +20,96 @@
  * - Filtering by column name
  * - Date range filtering
  * - Recursive directory processing
- * - Follow mode for files and stdin (like tail -f)
+ * - Follow mode for files and stdin (like tail -f), with a refresh throttle
+ * - Streaming mode: constant memory, estimated quartiles (--streaming)
+ * - Grouped tables per column value and/or time period, in one pass
  */
 class StatsAnalyser : public CommandBase {
 private:
+    /**
+     * Numeric data gathered for printStats. By default every value and
+     * timestamp is kept so quartiles, outliers and sampling intervals are
+     * exact; with --streaming only accumulators are, so memory stays the
+     * same however much is read. Workers each fill one and the results are
+     * appended in file order.
+     */
+    struct CollectedData {
+        bool streaming = false;
+        std::map<std::string, std::vector<double>> columnData;  // column name -> values
+        std::vector<long long> timestamps;  // All timestamps for time-based stats
+        std::map<std::string, SeriesStats> columnStats;  // --streaming: column name -> accumulators
+        TimestampStats timeStats;  // --streaming
+        
+        void addTimestamp(long long ts);
+        void addValue(const std::string& column, double value);
+        void append(CollectedData& later);  // later was read after this
+        bool empty() const { return streaming ? columnStats.empty() : columnData.empty(); }
+    };
+    
+    /**
+     * What printStats shows for the timestamps and for each column, worked
+     * out either from stored values or from accumulators
+     */
+    struct TimeSummary {
+        size_t count;
+        long long first;
+        long long last;
+        size_t intervalCount;
+        long long medianInterval;
+        size_t gapCount;  // intervals over 3x the median
+        long long maxGap;
+        bool estimated;  // medianInterval and gapCount come from a sketch
+    };
+    
+    struct ColumnSummary {
+        size_t count;
+        double min, max, mean, stddev;
+        double q1, median, q3;
+        size_t outlierCount;
+        bool estimated;  // quartiles and outlierCount come from a sketch
+        size_t deltaCount;
+        double deltaMin, deltaMax, deltaMean, volatility;
+        double jumpFrom, jumpTo;
+    };
+    
+    /**
+     * One cell of a grouped stats table (--by-column, --by-*): the row's
+     * --by-column value, its period as a DateUtils::periodKey, and the
+     * column analysed
+     */
+    struct GroupKey {
+        std::string value;  // empty without --by-column
+        long long period;   // 0 without a --by-* period
+        FieldKey column;
+        
+        bool operator==(const GroupKey& other) const {
+            return period == other.period && column == other.column && value == other.value;
+        }
+    };
+    
+    struct GroupKeyHash {
+        size_t operator()(const GroupKey& key) const {
+            size_t h = std::hash<std::string>()(key.value);
+            h ^= std::hash<long long>()(key.period) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>()(key.column.id()) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    
+    using GroupTable = std::unordered_map<GroupKey, DistributionStats, GroupKeyHash>;
+    
     std::string columnFilter;  // Specific column to analyze (empty = all, "value" = default)
-    std::map<std::string, std::vector<double>> columnData;  // column name -> values
-    std::vector<long long> timestamps;  // All timestamps for time-based stats
+    std::string byColumn;  // --by-column: a table row per value of this column
+    bool byPeriod;  // --by-hour/--by-day/--by-week/--by-month/--by-year given
+    DateUtils::Period period;  // which one
+    std::string outputFormat;  // --output-format for grouped tables: human, csv, json
+    std::string outputFile;  // -o, --output file path for grouped tables
+    CollectedData collected;
     bool followMode;  // --follow flag for continuous monitoring
+    double refreshInterval;  // --refresh-interval: minimum seconds between follow-mode refreshes
+    size_t refreshEvery;  // --refresh-every: new readings per follow-mode refresh
+    size_t unprintedReadings;  // follow mode: readings since the stats were last printed
+    std::chrono::steady_clock::time_point lastRefresh;
     
     /**
      * Check if a string is a valid numeric value
@@ -34,6 +121,33 @@ private:
      */
     void collectDataFromReading(const Reading& reading);
     
+    bool grouped() const { return !byColumn.empty() || byPeriod; }
+    
+    /**
+     * The table group a reading falls in, with no column set yet
+     */
+    GroupKey groupOf(const Reading& reading) const;
+    
+    /**
+     * Add a reading's numeric values to its group's cells
+     */
+    void collectGroupedFromReading(const Reading& reading, GroupTable& groups) const;
+    
+    static void mergeGroups(GroupTable& into, const GroupTable& from);
+    
+    /**
+     * Write the grouped table, sorted by group value, period and column,
+     * to --output or stdout in --output-format
+     */
+    void writeGroupedStats(const GroupTable& groups) const;
+    
+    static TimeSummary summarizeTimestamps(const std::vector<long long>& timestamps);
+    static TimeSummary summarizeTimestamps(const TimestampStats& stats);
+    static ColumnSummary summarizeColumn(const std::vector<double>& values);
+    static ColumnSummary summarizeColumn(const SeriesStats& stats);
+    static void printTimeSummary(const TimeSummary& summary);
+    static void printColumnSummary(const std::string& colName, const ColumnSummary& summary);
+    
     /**
      * Calculate median of a vector of values
      */
@@ -54,6 +168,22 @@ private:
      */
     void printStats();
     
+    /**
+     * Print the stats and the "---" that separates follow-mode refreshes
+     */
+    void refreshStats();
+    
+    /**
+     * Follow mode: add a new reading, and print the stats if --refresh-every
+     * readings have come in and --refresh-interval has passed since last time
+     */
+    void followReading(const Reading& reading);
+    
+    /**
+     * Follow mode: the input has run dry, so print any readings still unprinted
+     */
+    void followIdle();
+    
     /**
      * Analyze stdin with follow mode (like tail -f)
      */
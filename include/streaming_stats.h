@@ -0,0 +1,384 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Constant-memory accumulators for the stats command (--streaming).
+ *
+ * Each one takes values one at a time and can be merged with another of its
+ * kind, so a worker can summarise a file on its own and the results be
+ * combined afterwards, in file order where the order matters.
+ */
+
+/**
+ * RunningStats - count, mean, variance, min and max of a stream of values.
+ *
+ * Mean and variance are updated with Welford's method and merged with
+ * Chan et al.'s pairwise formula, so they stay accurate when the values are
+ * large compared to their spread (e.g. timestamps, or 1e6 + small noise).
+ */
+class RunningStats {
+public:
+    void add(double x) {
+        if (n == 0) {
+            lo = hi = x;
+        } else {
+            lo = std::min(lo, x);
+            hi = std::max(hi, x);
+        }
+        ++n;
+        double delta = x - mu;
+        mu += delta / static_cast<double>(n);
+        m2 += delta * (x - mu);
+    }
+
+    void merge(const RunningStats& other) {
+        if (other.n == 0) return;
+        if (n == 0) {
+            *this = other;
+            return;
+        }
+        double total = static_cast<double>(n + other.n);
+        double delta = other.mu - mu;
+        mu += delta * static_cast<double>(other.n) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(n) * static_cast<double>(other.n) / total;
+        lo = std::min(lo, other.lo);
+        hi = std::max(hi, other.hi);
+        n += other.n;
+    }
+
+    uint64_t count() const { return n; }
+    double min() const { return lo; }
+    double max() const { return hi; }
+    double mean() const { return mu; }
+
+    // Sample standard deviation (n - 1), 0 for fewer than two values
+    double stddev() const {
+        return n > 1 ? std::sqrt(m2 / static_cast<double>(n - 1)) : 0.0;
+    }
+
+private:
+    uint64_t n = 0;
+    double mu = 0.0;
+    double m2 = 0.0;  // sum of squared differences from the mean
+    double lo = 0.0;
+    double hi = 0.0;
+};
+
+/**
+ * QuantileSketch - a KLL sketch of a stream of values, for quantiles and
+ * ranks in bounded memory.
+ *
+ * Values are kept in levels; when a level fills up it is sorted and every
+ * other value moves up a level with twice the weight. With the default k of
+ * 200 it holds at most about 3k values however many are added, and a rank
+ * it reports is within about 1% of the number of values of the true one.
+ * Until the first level fills (fewer than k values) nothing has been
+ * dropped and every answer is exact.
+ *
+ * Which half of a level is kept is chosen by a fixed pseudo-random
+ * sequence, so the same input in the same order always gives the same
+ * answers.
+ */
+class QuantileSketch {
+public:
+    static constexpr size_t DEFAULT_K = 200;
+
+    explicit QuantileSketch(size_t k = DEFAULT_K)
+        : k(std::max<size_t>(k, MIN_WIDTH)), n(0), seed(SEED) {
+        addLevel();
+    }
+
+    void add(double x) {
+        levels[0].push_back(x);
+        ++n;
+        if (levels[0].size() >= capacities[0]) compress();
+    }
+
+    void merge(const QuantileSketch& other) {
+        while (levels.size() < other.levels.size()) addLevel();
+        for (size_t h = 0; h < other.levels.size(); ++h) {
+            levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+        }
+        n += other.n;
+        compress();
+    }
+
+    uint64_t count() const { return n; }
+
+    // True while every value added is still held, so answers are exact
+    bool exact() const { return levels.size() == 1; }
+
+    // The value with rank values below it in sorted order (0-based)
+    double select(uint64_t rank) const {
+        return selectIn(weighted(), rank);
+    }
+
+    /**
+     * Percentile (0-100), interpolated between the two nearest ranks the
+     * same way StatsAnalyser::calculatePercentile does on sorted values.
+     */
+    double percentile(double p) const {
+        if (n == 0) return 0.0;
+        auto items = weighted();
+        double index = (p / 100.0) * static_cast<double>(n - 1);
+        uint64_t lower = static_cast<uint64_t>(index);
+        double below = selectIn(items, lower);
+        if (lower + 1 >= n) return below;
+        double fraction = index - static_cast<double>(lower);
+        return below + fraction * (selectIn(items, lower + 1) - below);
+    }
+
+    // Number of values less than x
+    uint64_t countBelow(double x) const {
+        uint64_t count = 0;
+        forEachItem([&](double value, uint64_t weight) {
+            if (value < x) count += weight;
+        });
+        return count;
+    }
+
+    // Number of values greater than x
+    uint64_t countAbove(double x) const {
+        uint64_t count = 0;
+        forEachItem([&](double value, uint64_t weight) {
+            if (value > x) count += weight;
+        });
+        return count;
+    }
+
+private:
+    static constexpr size_t MIN_WIDTH = 8;
+    static constexpr uint64_t SEED = 0x9E3779B97F4A7C15ULL;
+
+    size_t k;
+    uint64_t n;
+    uint64_t seed;
+    std::vector<std::vector<double>> levels;  // level h holds values of weight 2^h
+    std::vector<size_t> capacities;           // how many values each level holds before compacting
+
+    // The top level holds k values, each level below it 2/3 as many
+    void addLevel() {
+        levels.emplace_back();
+        capacities.resize(levels.size());
+        double width = static_cast<double>(k);
+        for (size_t h = levels.size(); h-- > 0; width *= 2.0 / 3.0) {
+            capacities[h] = std::max<size_t>(MIN_WIDTH, static_cast<size_t>(std::ceil(width)));
+        }
+    }
+
+    bool coin() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed & 1;
+    }
+
+    void compress() {
+        bool compacted = true;
+        while (compacted) {
+            compacted = false;
+            for (size_t h = 0; h < levels.size(); ++h) {
+                if (levels[h].size() >= capacities[h]) {
+                    compact(h);
+                    compacted = true;
+                }
+            }
+        }
+    }
+
+    // Halve a level: sort it and move every other value up, keeping the odd one out
+    void compact(size_t h) {
+        if (h + 1 == levels.size()) addLevel();
+        std::vector<double>& level = levels[h];
+        std::sort(level.begin(), level.end());
+        size_t start = level.size() % 2;  // level[0] stays behind if the count is odd
+        for (size_t i = start + (coin() ? 1 : 0); i < level.size(); i += 2) {
+            levels[h + 1].push_back(level[i]);
+        }
+        level.resize(start);
+    }
+
+    template <typename Func>
+    void forEachItem(Func func) const {
+        for (size_t h = 0; h < levels.size(); ++h) {
+            for (double value : levels[h]) func(value, uint64_t(1) << h);
+        }
+    }
+
+    // Every held value with its weight, in sorted order
+    std::vector<std::pair<double, uint64_t>> weighted() const {
+        std::vector<std::pair<double, uint64_t>> items;
+        forEachItem([&](double value, uint64_t weight) { items.emplace_back(value, weight); });
+        std::sort(items.begin(), items.end());
+        return items;
+    }
+
+    static double selectIn(const std::vector<std::pair<double, uint64_t>>& items, uint64_t rank) {
+        if (items.empty()) return 0.0;
+        uint64_t seen = 0;
+        for (const auto& [value, weight] : items) {
+            seen += weight;
+            if (seen > rank) return value;
+        }
+        return items.back().first;
+    }
+};
+
+/**
+ * DistributionStats - RunningStats and a QuantileSketch of the same values,
+ * for summaries where their order doesn't matter (one cell of a grouped
+ * stats table).
+ */
+class DistributionStats {
+public:
+    void add(double x) {
+        values.add(x);
+        sketch.add(x);
+    }
+
+    void merge(const DistributionStats& other) {
+        values.merge(other.values);
+        sketch.merge(other.sketch);
+    }
+
+    const RunningStats& valueStats() const { return values; }
+    const QuantileSketch& quantiles() const { return sketch; }
+
+private:
+    RunningStats values;
+    QuantileSketch sketch;
+};
+
+/**
+ * SeriesStats - what the stats command reports for one column, in constant
+ * memory: RunningStats of the values and of the absolute differences
+ * between consecutive values, the largest such jump, and a QuantileSketch
+ * for the quartiles and outliers.
+ */
+class SeriesStats {
+public:
+    void add(double x) {
+        if (values.count() > 0) {
+            addDelta(last, x);
+        } else {
+            first = x;
+        }
+        last = x;
+        values.add(x);
+        sketch.add(x);
+    }
+
+    /**
+     * Merge the stats of values read after this one's, as if they had been
+     * added here one by one; the jump between the two runs counts as a delta.
+     */
+    void append(const SeriesStats& later) {
+        if (later.values.count() == 0) return;
+        if (values.count() == 0) {
+            *this = later;
+            return;
+        }
+        addDelta(last, later.first);
+        if (later.deltas.count() > 0 && later.deltas.max() > deltas.max()) {
+            jumpFrom = later.jumpFrom;
+            jumpTo = later.jumpTo;
+        }
+        deltas.merge(later.deltas);
+        last = later.last;
+        values.merge(later.values);
+        sketch.merge(later.sketch);
+    }
+
+    const RunningStats& valueStats() const { return values; }
+    const RunningStats& deltaStats() const { return deltas; }
+    const QuantileSketch& quantiles() const { return sketch; }
+
+    // The two values either side of the first largest delta
+    double maxJumpFrom() const { return jumpFrom; }
+    double maxJumpTo() const { return jumpTo; }
+
+private:
+    RunningStats values;
+    RunningStats deltas;
+    QuantileSketch sketch;
+    double first = 0.0;
+    double last = 0.0;
+    double jumpFrom = 0.0;
+    double jumpTo = 0.0;
+
+    void addDelta(double from, double to) {
+        double delta = std::abs(to - from);
+        if (deltas.count() == 0 || delta > deltas.max()) {
+            jumpFrom = from;
+            jumpTo = to;
+        }
+        deltas.add(delta);
+    }
+};
+
+/**
+ * TimestampStats - the time range and sampling intervals of a stream of
+ * timestamps, in constant memory.
+ *
+ * Intervals are taken between each timestamp and the latest one before it,
+ * so they match those of the sorted timestamps when readings arrive in time
+ * order; one that goes back in time adds no interval. Appending the stats
+ * of a later file adds the interval between the two if it starts after
+ * this one ends.
+ */
+class TimestampStats {
+public:
+    void add(long long ts) {
+        if (n == 0) {
+            first = last = head = ts;
+        } else {
+            first = std::min(first, ts);
+            if (ts >= last) {
+                addInterval(ts - last);
+                last = ts;
+            }
+        }
+        ++n;
+    }
+
+    void append(const TimestampStats& later) {
+        if (later.n == 0) return;
+        if (n == 0) {
+            *this = later;
+            return;
+        }
+        if (later.head >= last) addInterval(later.head - last);
+        gaps.merge(later.gaps);
+        if (later.gaps.count() > 0) longest = std::max(longest, later.longest);
+        first = std::min(first, later.first);
+        last = std::max(last, later.last);
+        n += later.n;
+    }
+
+    uint64_t count() const { return n; }
+    long long earliest() const { return first; }
+    long long latest() const { return last; }
+    const QuantileSketch& intervals() const { return gaps; }
+    long long longestInterval() const { return longest; }
+
+private:
+    uint64_t n = 0;
+    long long first = 0;  // earliest
+    long long last = 0;   // latest
+    long long head = 0;   // the first one added
+    QuantileSketch gaps;
+    long long longest = 0;
+
+    void addInterval(long long interval) {
+        if (gaps.count() == 0 || interval > longest) longest = interval;
+        gaps.add(static_cast<double>(interval));
+    }
+};
+
+#endif // STREAMING_STATS_H
@@ -0,0 +1,235 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool - persistent work-stealing pool shared by all commands.
+ *
+ * forEach() deals its tasks round-robin onto per-worker queues in the order
+ * given. Each worker takes from the front of its own queue and, once that
+ * is empty, steals from the back of another worker's, so no thread sits idle
+ * while work is queued anywhere. Submitting tasks largest-first starts the
+ * big ones early and leaves the small ones to fill the gaps.
+ *
+ * forEach() blocks until all of its tasks have run. A pool worker that calls
+ * it runs queued tasks while it waits, so nested use cannot deadlock.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t numThreads)
+        : queues(std::max(size_t(1), numThreads)), queued(0), stopping(false) {
+        workers.reserve(queues.size());
+        for (size_t i = 0; i < queues.size(); ++i) {
+            workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // The pool used for file-level and chunk-level parallelism
+    static ThreadPool& shared() {
+        static ThreadPool pool(sharedSize());
+        return pool;
+    }
+
+    /**
+     * Set the number of workers in the shared pool (-j). Only takes effect
+     * if called before the first use of shared().
+     */
+    static void setSharedSize(size_t n) {
+        sharedSize() = std::max(size_t(1), n);
+    }
+
+    size_t size() const { return queues.size(); }
+
+    /**
+     * Run task(i) for every i in [0, count) and wait for all of them.
+     * Tasks are queued in index order. If any task throws, the first
+     * exception is rethrown here once every task has finished.
+     */
+    template<typename Task>
+    void forEach(size_t count, Task task) {
+        if (count == 0) return;
+
+        Job job;
+        job.run = std::function<void(size_t)>(std::move(task));
+        job.remaining = count;
+
+        // Count the tasks before queueing them so no worker sees more items than queued
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            queued += static_cast<long>(count);
+        }
+        size_t first = (currentPool == this) ? currentIndex : 0;
+        for (size_t i = 0; i < count; ++i) {
+            Queue& queue = queues[(first + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.push_back({&job, i});
+        }
+        wake.notify_all();
+
+        if (currentPool == this) {
+            Item item;
+            while (takeWork(currentIndex, item)) {
+                execute(item);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.done.wait(lock, [&job]() { return job.remaining == 0; });
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    /**
+     * Sort [first, last) with every worker: one run per worker is sorted on
+     * its own, then pairs of neighbouring runs are merged, in parallel,
+     * until one is left. Small ranges, or a pool of one, use std::sort.
+     */
+    template<typename RandomIt>
+    void sort(RandomIt first, RandomIt last) {
+        constexpr size_t MIN_RUN = 1 << 15;
+        size_t n = static_cast<size_t>(last - first);
+        size_t runs = std::min(size(), n / MIN_RUN);
+        if (runs <= 1) {
+            std::sort(first, last);
+            return;
+        }
+
+        std::vector<size_t> bounds;  // run r is [bounds[r], bounds[r + 1])
+        for (size_t r = 0; r <= runs; ++r) bounds.push_back(n * r / runs);
+        forEach(runs, [&](size_t r) {
+            std::sort(first + bounds[r], first + bounds[r + 1]);
+        });
+        while (bounds.size() > 2) {
+            size_t pairs = (bounds.size() - 1) / 2;
+            forEach(pairs, [&](size_t p) {
+                std::inplace_merge(first + bounds[2 * p], first + bounds[2 * p + 1], first + bounds[2 * p + 2]);
+            });
+            // Drop the bound between each merged pair
+            std::vector<size_t> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2) merged.push_back(bounds[i]);
+            if (merged.back() != bounds.back()) merged.push_back(bounds.back());
+            bounds.swap(merged);
+        }
+    }
+
+private:
+    struct Job {
+        std::function<void(size_t)> run;
+        size_t remaining;  // guarded by mutex
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    struct Item {
+        Job* job;
+        size_t index;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Item> items;
+    };
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<long> queued;  // items in all queues
+    bool stopping;             // guarded by wakeMutex
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+
+    static size_t& sharedSize() {
+        static size_t size = std::max(1u, std::thread::hardware_concurrency());
+        return size;
+    }
+
+    static inline thread_local const ThreadPool* currentPool = nullptr;
+    static inline thread_local size_t currentIndex = 0;
+
+    // Take from the front of our own queue, else steal from the back of another
+    bool takeWork(size_t self, Item& item) {
+        {
+            Queue& own = queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.items.empty()) {
+                item = own.items.front();
+                own.items.pop_front();
+                --queued;
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); ++k) {
+            Queue& victim = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                item = victim.items.back();
+                victim.items.pop_back();
+                --queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void execute(const Item& item) {
+        Job& job = *item.job;
+        std::exception_ptr error;
+        try {
+            job.run(item.index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // The waiting caller owns job, so touch it only under its lock
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (error && !job.error) {
+            job.error = error;
+        }
+        if (--job.remaining == 0) {
+            job.done.notify_all();
+        }
+    }
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+
+        while (true) {
+            Item item;
+            if (takeWork(index, item)) {
+                execute(item);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this]() { return stopping || queued > 0; });
+            if (stopping && queued <= 0) return;
+        }
+    }
+};
+
+#endif // THREAD_POOL_H
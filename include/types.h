@@ -2,11 +2,187 @@
 #define SENSOR_TYPES_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
+
+#include "field_key.h"
+
+// The previous hash-map representation of a reading. Kept as a compatibility
+// path for callers that need real map semantics; convert with
+// Reading(const ReadingMap&) and Reading::toMap().
+using ReadingMap = std::unordered_map<std::string, std::string>;
+
+/**
+ * Reading - one sensor row as a flat, insertion-ordered list of key/value pairs.
+ *
+ * Keys are interned FieldKeys, so lookups compare integer IDs. Lookups by
+ * string intern the name first; use the Keys:: constants on hot paths.
+ *
+ * Sensor rows have 6-8 fields, so a linear scan over contiguous entries beats
+ * hashing, and a row costs one allocation instead of a bucket array plus a
+ * node and two strings per field. The interface mirrors the subset of
+ * std::unordered_map used across the tree (find/at/count/operator[]/emplace,
+ * iteration with ->first/->second), so commands did not need to change.
+ *
+ * Like emplace() on a map, inserting a key that already exists keeps the
+ * existing value. Equality ignores field order.
+ *
+ * clear() keeps the previous entries alive past size() so that refilling a
+ * reused Reading (see JsonParser::toReading) assigns into strings that already
+ * own a buffer instead of allocating fresh ones.
+ */
+class Reading {
+public:
+    using key_type = FieldKey;
+    using mapped_type = std::string;
+    using value_type = std::pair<FieldKey, std::string>;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+    using size_type = size_t;
+
+    Reading() : used(0) {}
+
+    Reading(std::initializer_list<value_type> init) : used(0) {
+        reserve(init.size());
+        for (const auto& kv : init) {
+            emplace(kv.first, kv.second);
+        }
+    }
+
+    explicit Reading(const ReadingMap& map) : used(0) {
+        reserve(map.size());
+        for (const auto& [key, value] : map) {
+            emplace(key, value);
+        }
+    }
+
+    Reading(const Reading& other) : entries(other.begin(), other.end()), used(other.used) {}
+    Reading(Reading&& other) noexcept : entries(std::move(other.entries)), used(other.used) {
+        other.used = 0;
+    }
+
+    Reading& operator=(const Reading& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.used);
+            for (const auto& kv : other) {
+                append(kv.first, kv.second);
+            }
+        }
+        return *this;
+    }
+
+    Reading& operator=(Reading&& other) noexcept {
+        entries = std::move(other.entries);
+        used = other.used;
+        other.used = 0;
+        return *this;
+    }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.begin() + used; }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.begin() + used; }
+
+    size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+    void reserve(size_t n) { entries.reserve(n); }
+    void clear() { used = 0; }
+
+    iterator find(FieldKey key) {
+        for (auto it = begin(), last = end(); it != last; ++it) {
+            if (it->first == key) return it;
+        }
+        return end();
+    }
+
+    const_iterator find(FieldKey key) const {
+        for (auto it = begin(), last = end(); it != last; ++it) {
+            if (it->first == key) return it;
+        }
+        return end();
+    }
+
+    size_t count(FieldKey key) const { return find(key) != end() ? 1 : 0; }
+
+    const std::string& at(FieldKey key) const {
+        auto it = find(key);
+        if (it == end()) throw std::out_of_range("Reading::at: missing key");
+        return it->second;
+    }
+
+    std::string& at(FieldKey key) {
+        auto it = find(key);
+        if (it == end()) throw std::out_of_range("Reading::at: missing key");
+        return it->second;
+    }
+
+    std::string& operator[](FieldKey key) {
+        auto it = find(key);
+        if (it != end()) return it->second;
+        return append(key, std::string_view()).second;
+    }
+
+    template<typename V>
+    std::pair<iterator, bool> emplace(FieldKey key, V&& value) {
+        auto it = find(key);
+        if (it != end()) return {it, false};
+        append(key, std::forward<V>(value));
+        return {end() - 1, true};
+    }
+
+    size_t erase(FieldKey key) {
+        auto it = find(key);
+        if (it == end()) return 0;
+        // Keep field order; the erased slot moves into the spare area
+        std::rotate(it, it + 1, end());
+        --used;
+        return 1;
+    }
+
+    ReadingMap toMap() const {
+        ReadingMap map;
+        map.reserve(used);
+        for (const auto& [key, value] : *this) {
+            map.emplace(key, value);
+        }
+        return map;
+    }
+
+    friend bool operator==(const Reading& a, const Reading& b) {
+        if (a.used != b.used) return false;
+        for (const auto& [key, value] : a) {
+            auto it = b.find(key);
+            if (it == b.end() || it->second != value) return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const Reading& a, const Reading& b) { return !(a == b); }
+
+private:
+    std::vector<value_type> entries;  // [0, used) are live; the rest are spare buffers
+    size_t used;
+
+    // Add a new entry without checking for duplicates, reusing a spare slot if any
+    template<typename V>
+    value_type& append(FieldKey key, V&& value) {
+        if (used < entries.size()) {
+            value_type& slot = entries[used];
+            slot.first = key;
+            slot.second.assign(std::string_view(value));
+        } else {
+            entries.emplace_back(key, std::string(std::forward<V>(value)));
+        }
+        return entries[used++];
+    }
+};
 
-// Use unordered_map for O(1) lookups instead of O(log n) with std::map
-using Reading = std::unordered_map<std::string, std::string>;
 using ReadingList = std::vector<Reading>;
 
 // Column-oriented storage for memory efficiency with large datasets
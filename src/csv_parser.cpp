@@ -1,12 +1,21 @@
 #include "csv_parser.h"
 #include <utility>
 
-std::vector<std::string> CsvParser::parseCsvLine(std::istream& input, std::string& line, bool& needMoreLines) {
+namespace {
+    // Whether field i is wanted by a parseCsvLine/parseCsvRecord keep mask
+    bool keepsField(const std::vector<bool>* keep, size_t i) {
+        return !keep || (i < keep->size() && (*keep)[i]);
+    }
+}
+
+std::vector<std::string> CsvParser::parseCsvLine(std::istream& input, std::string& line, bool& needMoreLines,
+                                                  const std::vector<bool>* keep) {
     std::vector<std::string> fields;
     fields.reserve(16);  // Typical CSV has 10-20 columns
     std::string current;
     current.reserve(64);  // Pre-allocate for typical field length
     bool inQuotes = false;
+    bool keeping = keepsField(keep, 0);
     needMoreLines = false;
     
     while (true) {
@@ -17,13 +26,13 @@ std::vector<std::string> CsvParser::parseCsvLine(std::istream& input, std::strin
                 if (c == '"') {
                     // Check if it's an escaped quote
                     if (i + 1 < line.length() && line[i + 1] == '"') {
-                        current += '"';
+                        if (keeping) current += '"';
                         ++i;  // Skip next quote
                     } else {
                         inQuotes = false;
                     }
                 } else {
-                    current += c;
+                    if (keeping) current += c;
                 }
             } else {
                 if (c == '"') {
@@ -31,8 +40,9 @@ std::vector<std::string> CsvParser::parseCsvLine(std::istream& input, std::strin
                 } else if (c == ',') {
                     fields.emplace_back(std::move(current));
                     current.clear();
-                    current.reserve(64);
-                } else if (c != '\r') {  // Ignore CR in CRLF
+                    keeping = keepsField(keep, fields.size());
+                    if (keeping) current.reserve(64);
+                } else if (c != '\r' && keeping) {  // Ignore CR in CRLF
                     current += c;
                 }
             }
@@ -40,7 +50,7 @@ std::vector<std::string> CsvParser::parseCsvLine(std::istream& input, std::strin
         
         // If we're still in quotes, we need to read more lines
         if (inQuotes) {
-            current += '\n';  // Add newline that was consumed by getline
+            if (keeping) current += '\n';  // Add newline that was consumed by getline
             if (std::getline(input, line)) {
                 needMoreLines = true;
                 continue;  // Continue parsing with the next line
@@ -96,3 +106,59 @@ std::vector<std::string> CsvParser::parseCsvLine(const std::string& line) {
     fields.emplace_back(std::move(current));
     return fields;
 }
+
+std::vector<FieldKey> CsvParser::parseCsvHeader(std::istream& input, std::string& line, bool& needMoreLines) {
+    std::vector<std::string> names = parseCsvLine(input, line, needMoreLines);
+    return std::vector<FieldKey>(names.begin(), names.end());
+}
+
+std::vector<std::string> CsvParser::parseCsvRecord(std::string_view data, size_t& pos,
+                                                    const std::vector<bool>* keep) {
+    std::vector<std::string> fields;
+    fields.reserve(16);  // Typical CSV has 10-20 columns
+    std::string current;
+    current.reserve(64);  // Pre-allocate for typical field length
+    bool inQuotes = false;
+    bool keeping = keepsField(keep, 0);
+    
+    size_t i = pos;
+    for (; i < data.size(); ++i) {
+        char c = data[i];
+        
+        if (inQuotes) {
+            if (c == '"') {
+                // Check if it's an escaped quote
+                if (i + 1 < data.size() && data[i + 1] == '"') {
+                    if (keeping) current += '"';
+                    ++i;  // Skip next quote
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                if (keeping) current += c;  // Includes newlines inside quoted fields
+            }
+        } else {
+            if (c == '\n') {
+                break;  // End of this logical line
+            } else if (c == '"') {
+                inQuotes = true;
+            } else if (c == ',') {
+                fields.emplace_back(std::move(current));
+                current.clear();
+                keeping = keepsField(keep, fields.size());
+                if (keeping) current.reserve(64);
+            } else if (c != '\r' && keeping) {  // Ignore CR in CRLF
+                current += c;
+            }
+        }
+    }
+    
+    pos = (i < data.size()) ? i + 1 : data.size();
+    fields.emplace_back(std::move(current));
+    return fields;
+}
+
+std::vector<FieldKey> CsvParser::parseCsvHeader(std::string_view data, size_t& pos) {
+    std::vector<std::string> names = parseCsvRecord(data, pos);
+    return std::vector<FieldKey>(names.begin(), names.end());
+}
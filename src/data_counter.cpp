@@ -16,6 +16,25 @@
 
 // ===== Private methods =====
 
+void DataCounter::tally(const Reading& reading, std::unordered_map<std::string, long long>& counts,
+                        std::unordered_map<long long, long long>& periodCounts) const {
+    if (!byColumn.empty()) {
+        auto it = reading.find(byColumn);
+        std::string value = (it != reading.end()) ? it->second : "(missing)";
+        counts[value]++;
+    }
+    if (byMonth || byDay || byYear || byWeek) {
+        periodCounts[DateUtils::periodKey(DateUtils::getTimestamp(reading), timePeriod())]++;
+    }
+}
+
+void DataCounter::addPeriodCounts(const std::unordered_map<long long, long long>& periodCounts,
+                                  std::unordered_map<std::string, long long>& counts) const {
+    for (const auto& [key, cnt] : periodCounts) {
+        counts[DateUtils::periodLabel(key, timePeriod())] += cnt;
+    }
+}
+
 long long DataCounter::countFromFile(const std::string& filename) {
     if (verbosity >= 1) {
         std::cerr << "Counting: " << filename << std::endl;
@@ -23,31 +42,15 @@ long long DataCounter::countFromFile(const std::string& filename) {
 
     long long count = 0;
     std::unordered_map<std::string, long long> localValueCounts;  // Local counts for thread safety
+    std::unordered_map<long long, long long> localPeriodCounts;  // by DateUtils::periodKey
     DataReader reader = createDataReader();
     
     reader.processFile(filename, [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
         // Filtering already done by DataReader
         count++;
-        if (!byColumn.empty()) {
-            auto it = reading.find(byColumn);
-            std::string value = (it != reading.end()) ? it->second : "(missing)";
-            localValueCounts[value]++;
-        }
-        if (byMonth || byDay || byYear || byWeek) {
-            long long ts = DateUtils::getTimestamp(reading);
-            std::string period;
-            if (byDay) {
-                period = DateUtils::timestampToDay(ts);
-            } else if (byWeek) {
-                period = DateUtils::timestampToWeek(ts);
-            } else if (byMonth) {
-                period = DateUtils::timestampToMonth(ts);
-            } else if (byYear) {
-                period = DateUtils::timestampToYear(ts);
-            }
-            localValueCounts[period]++;
-        }
+        tally(reading, localValueCounts, localPeriodCounts);
     });
+    addPeriodCounts(localPeriodCounts, localValueCounts);
 
     // Merge local counts into shared valueCounts with mutex
     if ((!byColumn.empty() || byMonth || byDay || byYear || byWeek) && !localValueCounts.empty()) {
@@ -67,32 +70,16 @@ long long DataCounter::countFromStdin() {
 
     long long count = 0;
     std::unordered_map<std::string, long long> localValueCounts;  // Local counts for thread safety
+    std::unordered_map<long long, long long> localPeriodCounts;  // by DateUtils::periodKey
     
     DataReader reader = createDataReader();
     
     reader.processStdin([&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
         // Filtering already done by DataReader
         count++;
-        if (!byColumn.empty()) {
-            auto it = reading.find(byColumn);
-            std::string value = (it != reading.end()) ? it->second : "(missing)";
-            localValueCounts[value]++;
-        }
-        if (byMonth || byDay || byYear || byWeek) {
-            long long ts = DateUtils::getTimestamp(reading);
-            std::string period;
-            if (byDay) {
-                period = DateUtils::timestampToDay(ts);
-            } else if (byWeek) {
-                period = DateUtils::timestampToWeek(ts);
-            } else if (byMonth) {
-                period = DateUtils::timestampToMonth(ts);
-            } else if (byYear) {
-                period = DateUtils::timestampToYear(ts);
-            }
-            localValueCounts[period]++;
-        }
+        tally(reading, localValueCounts, localPeriodCounts);
     });
+    addPeriodCounts(localPeriodCounts, localValueCounts);
 
     // Merge local counts into shared valueCounts with mutex
     if ((!byColumn.empty() || byMonth || byDay || byYear || byWeek) && !localValueCounts.empty()) {
@@ -195,6 +182,17 @@ DataCounter::DataCounter(int argc, char* argv[]) : followMode(false), byColumn("
     }
 
     copyFromParser(parser);
+    
+    // Plain counts read no column at all
+    if (!byColumn.empty() && timeGroupCount > 0) {
+        requireColumns({byColumn, Keys::Timestamp.str()});
+    } else if (!byColumn.empty()) {
+        requireColumns({byColumn});
+    } else if (timeGroupCount > 0) {
+        requireColumns({Keys::Timestamp.str()});
+    } else {
+        requireColumns({});
+    }
 
     // Check for unknown options using filtered argv
     std::string unknownOpt = CommonArgParser::checkUnknownOptions(
@@ -233,12 +231,14 @@ void DataCounter::count() {
         totalCount = countFromStdin();
     } else if (uniqueRows) {
         // When --unique is enabled, use parallel processing with a shared filter
-        // The shared filter's seenRows set is mutex-protected for thread safety
+        // The shared filter's seen-row set is sharded, so workers claim rows concurrently;
+        // which copy of a duplicate wins does not change the counts
         ReadingFilter sharedFilter = createFilter();
         
         auto processFileWithSharedFilter = [this, &sharedFilter](const std::string& file) -> std::pair<long long, std::unordered_map<std::string, long long>> {
             long long count = 0;
             std::unordered_map<std::string, long long> localValueCounts;
+            std::unordered_map<long long, long long> localPeriodCounts;
             
             if (verbosity >= 1) {
                 std::lock_guard<std::mutex> lock(valueCountsMutex);
@@ -248,26 +248,9 @@ void DataCounter::count() {
             DataReader reader = createDataReaderWithSharedFilter(sharedFilter);
             reader.processFile(file, [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
                 count++;
-                if (!byColumn.empty()) {
-                    auto it = reading.find(byColumn);
-                    std::string value = (it != reading.end()) ? it->second : "(missing)";
-                    localValueCounts[value]++;
-                }
-                if (byMonth || byDay || byYear || byWeek) {
-                    long long ts = DateUtils::getTimestamp(reading);
-                    std::string period;
-                    if (byDay) {
-                        period = DateUtils::timestampToDay(ts);
-                    } else if (byWeek) {
-                        period = DateUtils::timestampToWeek(ts);
-                    } else if (byMonth) {
-                        period = DateUtils::timestampToMonth(ts);
-                    } else if (byYear) {
-                        period = DateUtils::timestampToYear(ts);
-                    }
-                    localValueCounts[period]++;
-                }
+                tally(reading, localValueCounts, localPeriodCounts);
             });
+            addPeriodCounts(localPeriodCounts, localValueCounts);
             
             return {count, localValueCounts};
         };
@@ -287,7 +270,7 @@ void DataCounter::count() {
             processFileWithSharedFilter,
             combineResults,
             std::make_pair(0LL, std::unordered_map<std::string, long long>()),
-            4  // numThreads
+            jobs
         );
         
         auto& [count, counts] = result;
@@ -300,7 +283,7 @@ void DataCounter::count() {
             [this](const std::string& file) { return countFromFile(file); },
             [](long long& acc, long long val) { acc += val; },
             0LL,
-            4  // numThreads
+            jobs
         );
     }
 
@@ -421,6 +404,8 @@ void DataCounter::printCountUsage(const char* progName) {
     std::cerr << "  -V                        Very verbose output (show detailed progress)" << std::endl;
     std::cerr << "  -e, --extension <ext>     Filter files by extension (e.g., .out or out)" << std::endl;
     std::cerr << "  -d, --depth <n>           Maximum recursion depth (0 = current dir only)" << std::endl;
+    std::cerr << "  -j, --jobs <n>            Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>             Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  --not-empty <column>      Skip rows where column is empty (can be used multiple times)" << std::endl;
     std::cerr << "  --not-null <column>       Skip rows where column is 'null' (can be used multiple times)" << std::endl;
     std::cerr << "  --only-value <col:val>    Only include rows where column has specific value" << std::endl;
@@ -430,6 +415,8 @@ void DataCounter::printCountUsage(const char* progName) {
     std::cerr << "  --remove-empty-json       Remove empty JSON input lines (e.g., [{}], [])" << std::endl;
     std::cerr << "  --clean                   Shorthand for --remove-empty-json --not-empty value --remove-errors --not-null value --not-null sensor_id --unique" << std::endl;
     std::cerr << "  --unique                  Only output unique rows (removes duplicates)" << std::endl;
+    std::cerr << "  --unique-exact            Like --unique, but compare whole rows instead of 128-bit hashes" << std::endl;
+    std::cerr << "  --unique-memory <MB>      Like --unique, but keep seen rows within MB of memory, spilling to disk beyond it" << std::endl;
     std::cerr << "  --min-date <date>         Filter readings after this date" << std::endl;
     std::cerr << "  --max-date <date>         Filter readings before this date" << std::endl;
     std::cerr << "  --tail <n>                Only read the last n lines from each file" << std::endl;
@@ -2,7 +2,6 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <future>
 
 #include "csv_parser.h"
 #include "json_parser.h"
@@ -206,6 +205,7 @@ DistinctLister::DistinctLister(int argc, char* argv[])
     }
 
     copyFromParser(parser);
+    requireColumns({columnName});
 
     // Check for unknown options using filtered argv
     std::string unknownOpt = CommonArgParser::checkUnknownOptions(
@@ -223,75 +223,46 @@ void DistinctLister::listDistinct() {
     if (hasInputFiles) {
         if (uniqueRows) {
             // When --unique is enabled, use parallel processing with a shared filter
-            // The shared filter's seenRows set is mutex-protected for thread safety
+            // Workers claim rows in the shared, sharded seen-row set as they go;
+            // any copy of a duplicate yields the same distinct values
             ReadingFilter sharedFilter = createFilter();
             
-            size_t numThreads = std::min(inputFiles.size(), static_cast<size_t>(8));
-            size_t filesPerThread = std::max(size_t(1), inputFiles.size() / numThreads);
-            std::vector<std::future<void>> futures;
-            futures.reserve(numThreads);
-            
-            for (size_t i = 0; i < inputFiles.size(); i += filesPerThread) {
-                size_t end = std::min(i + filesPerThread, inputFiles.size());
+            processFilesParallelVoid(inputFiles, [this, &sharedFilter](const std::string& file) {
+                std::set<std::string> localValues;
+                std::map<std::string, long long> localCounts;
+                
+                if (verbosity >= 1) {
+                    std::lock_guard<std::mutex> lock(valuesMutex);
+                    std::cerr << "Processing: " << file << std::endl;
+                }
                 
-                futures.push_back(std::async(std::launch::async, [this, i, end, &sharedFilter]() {
-                    std::set<std::string> localValues;
-                    std::map<std::string, long long> localCounts;
-                    
-                    for (size_t j = i; j < end; ++j) {
-                        if (verbosity >= 1) {
-                            std::lock_guard<std::mutex> lock(valuesMutex);
-                            std::cerr << "Processing: " << inputFiles[j] << std::endl;
+                DataReader reader = createDataReaderWithSharedFilter(sharedFilter);
+                reader.processFile(file, [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
+                    auto it = reading.find(columnName);
+                    if (it != reading.end() && !it->second.empty()) {
+                        localValues.insert(it->second);
+                        if (showCounts) {
+                            localCounts[it->second]++;
                         }
-                        
-                        DataReader reader = createDataReaderWithSharedFilter(sharedFilter);
-                        reader.processFile(inputFiles[j], [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
-                            auto it = reading.find(columnName);
-                            if (it != reading.end() && !it->second.empty()) {
-                                localValues.insert(it->second);
-                                if (showCounts) {
-                                    localCounts[it->second]++;
-                                }
-                            }
-                        });
                     }
-                    
-                    // Merge local values into shared set with mutex
-                    if (!localValues.empty()) {
-                        std::lock_guard<std::mutex> lock(valuesMutex);
-                        distinctValues.insert(localValues.begin(), localValues.end());
-                        if (showCounts) {
-                            for (const auto& pair : localCounts) {
-                                valueCounts[pair.first] += pair.second;
-                            }
+                });
+                
+                // Merge local values into shared set with mutex
+                if (!localValues.empty()) {
+                    std::lock_guard<std::mutex> lock(valuesMutex);
+                    distinctValues.insert(localValues.begin(), localValues.end());
+                    if (showCounts) {
+                        for (const auto& pair : localCounts) {
+                            valueCounts[pair.first] += pair.second;
                         }
                     }
-                }));
-            }
-            
-            for (auto& f : futures) {
-                f.wait();
-            }
+                }
+            }, jobs);
         } else {
             // Multi-threaded file processing
-            size_t numThreads = std::min(inputFiles.size(), static_cast<size_t>(8));
-            size_t filesPerThread = std::max(size_t(1), inputFiles.size() / numThreads);
-            std::vector<std::future<void>> futures;
-            futures.reserve(numThreads);
-            
-            for (size_t i = 0; i < inputFiles.size(); i += filesPerThread) {
-                size_t end = std::min(i + filesPerThread, inputFiles.size());
-                
-                futures.push_back(std::async(std::launch::async, [this, i, end]() {
-                    for (size_t j = i; j < end; ++j) {
-                        collectFromFile(inputFiles[j]);
-                    }
-                }));
-            }
-            
-            for (auto& f : futures) {
-                f.wait();
-            }
+            processFilesParallelVoid(inputFiles, [this](const std::string& file) {
+                collectFromFile(file);
+            }, jobs);
         }
     } else {
         collectFromStdin();
@@ -319,6 +290,8 @@ void DistinctLister::printDistinctUsage(const char* progName) {
     std::cerr << "Common options:" << std::endl;
     std::cerr << "  -r, --recursive         Process directories recursively" << std::endl;
     std::cerr << "  -d, --depth <n>         Maximum recursion depth" << std::endl;
+    std::cerr << "  -j, --jobs <n>          Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>           Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  -e, --ext <extension>   Filter by file extension (without dot)" << std::endl;
     std::cerr << "  -if, --input-format <format>   Input format: json (default), csv" << std::endl;
     std::cerr << "  -v, --verbose           Increase verbosity" << std::endl;
@@ -326,6 +299,8 @@ void DistinctLister::printDistinctUsage(const char* progName) {
     std::cerr << "Filter options:" << std::endl;
     std::cerr << "  --clean                 Remove readings with errors and enable --unique" << std::endl;
     std::cerr << "  --unique                Only output unique rows (removes duplicates)" << std::endl;
+    std::cerr << "  --unique-exact          Like --unique, but compare whole rows instead of 128-bit hashes" << std::endl;
+    std::cerr << "  --unique-memory <MB>    Like --unique, but keep seen rows within MB of memory, spilling to disk beyond it" << std::endl;
     std::cerr << "  --after <date>          Only include readings after date" << std::endl;
     std::cerr << "  --before <date>         Only include readings before date" << std::endl;
     std::cerr << "  --only-value <col:val>  Only include readings where col=val" << std::endl;
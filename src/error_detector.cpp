@@ -136,7 +136,7 @@ std::string ErrorDetector::getErrorDescription(const Reading& reading) {
     ensureLoaded();
     
     // Get the sensor type
-    auto sensorIt = reading.find("sensor");
+    auto sensorIt = reading.find(Keys::Sensor);
     if (sensorIt == reading.end()) {
         return "";
     }
@@ -158,3 +158,15 @@ std::string ErrorDetector::getErrorDescription(const Reading& reading) {
     
     return "";
 }
+
+std::vector<FieldKey> ErrorDetector::getCheckedColumns() {
+    ensureLoaded();
+    
+    std::vector<FieldKey> columns{Keys::Sensor};
+    for (const auto& def : errorDefinitions) {
+        if (std::find(columns.begin(), columns.end(), def.field) == columns.end()) {
+            columns.push_back(def.field);
+        }
+    }
+    return columns;
+}
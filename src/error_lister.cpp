@@ -13,11 +13,11 @@ void ErrorLister::printErrorLine(const Reading& reading,
     std::cout << source << ":" << lineNum;
     
     // Print relevant fields
-    auto sensorIt = reading.find("sensor");
-    auto valueIt = reading.find("value");
+    auto sensorIt = reading.find(Keys::Sensor);
+    auto valueIt = reading.find(Keys::Value);
     auto tempIt = reading.find("temperature");
-    auto idIt = reading.find("sensor_id");
-    auto nameIt = reading.find("name");
+    auto idIt = reading.find(Keys::SensorId);
+    auto nameIt = reading.find(Keys::Name);
     
     if (sensorIt != reading.end()) std::cout << " sensor=" << sensorIt->second;
     if (idIt != reading.end()) std::cout << " sensor_id=" << idIt->second;
@@ -68,11 +68,11 @@ void ErrorLister::listErrors() {
             
             std::cout << source << ":" << lineNum;
             
-            auto sensorIt = reading.find("sensor");
-            auto valueIt = reading.find("value");
+            auto sensorIt = reading.find(Keys::Sensor);
+            auto valueIt = reading.find(Keys::Value);
             auto tempIt = reading.find("temperature");
-            auto idIt = reading.find("sensor_id");
-            auto nameIt = reading.find("name");
+            auto idIt = reading.find(Keys::SensorId);
+            auto nameIt = reading.find(Keys::Name);
             
             if (sensorIt != reading.end()) std::cout << " sensor=" << sensorIt->second;
             if (idIt != reading.end()) std::cout << " sensor_id=" << idIt->second;
@@ -102,11 +102,11 @@ void ErrorLister::listErrors() {
             oss << source << ":" << lineNum;
             
             // Print relevant fields
-            auto sensorIt = reading.find("sensor");
-            auto valueIt = reading.find("value");
+            auto sensorIt = reading.find(Keys::Sensor);
+            auto valueIt = reading.find(Keys::Value);
             auto tempIt = reading.find("temperature");
-            auto idIt = reading.find("sensor_id");
-            auto nameIt = reading.find("name");
+            auto idIt = reading.find(Keys::SensorId);
+            auto nameIt = reading.find(Keys::Name);
             
             if (sensorIt != reading.end()) oss << " sensor=" << sensorIt->second;
             if (idIt != reading.end()) oss << " sensor_id=" << idIt->second;
@@ -129,7 +129,7 @@ void ErrorLister::listErrors() {
     };
     
     std::vector<std::string> allErrors = processFilesParallel(inputFiles, processFile, combineErrors, 
-                                                               std::vector<std::string>());
+                                                               std::vector<std::string>(), jobs);
     
     // Output all collected errors
     for (const auto& line : allErrors) {
@@ -153,6 +153,8 @@ void ErrorLister::printListErrorsUsage(const char* progName) {
     std::cerr << "  -V                        Very verbose output" << std::endl;
     std::cerr << "  -e, --extension <ext>     Filter files by extension (e.g., .out or out)" << std::endl;
     std::cerr << "  -d, --depth <n>           Maximum recursion depth (0 = current dir only)" << std::endl;
+    std::cerr << "  -j, --jobs <n>            Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>             Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  --min-date <date>         Filter readings after this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << "  --max-date <date>         Filter readings before this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << std::endl;
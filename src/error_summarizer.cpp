@@ -71,7 +71,7 @@ void ErrorSummarizer::summariseErrors() {
         };
         
         errorCounts = processFilesParallel(inputFiles, processFile, combineCounts, 
-                                           std::map<std::string, int>());
+                                           std::map<std::string, int>(), jobs);
     }
     
     // Print summary
@@ -104,6 +104,8 @@ void ErrorSummarizer::printSummariseErrorsUsage(const char* progName) {
     std::cerr << "  -V                        Very verbose output" << std::endl;
     std::cerr << "  -e, --extension <ext>     Filter files by extension (e.g., .out or out)" << std::endl;
     std::cerr << "  -d, --depth <n>           Maximum recursion depth (0 = current dir only)" << std::endl;
+    std::cerr << "  -j, --jobs <n>            Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>             Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  --min-date <date>         Filter readings after this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << "  --max-date <date>         Filter readings before this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << std::endl;
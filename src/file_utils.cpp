@@ -4,6 +4,12 @@
 #include <fstream>
 #include <deque>
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 bool FileUtils::isDirectory(const std::string& path) {
     struct stat info;
     if (stat(path.c_str(), &info) != 0) {
@@ -72,3 +78,59 @@ std::vector<std::string> FileUtils::readTailLines(const std::string& filename, i
     
     return result;
 }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return true;  // mmap rejects zero-length mappings
+    }
+    
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+    if (mapped == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    addr = mapped;
+    return true;
+}
+
+void MappedFile::close() {
+    if (addr) {
+        munmap(addr, length);
+    }
+    addr = nullptr;
+    length = 0;
+}
+
+#else
+
+// No mmap on Windows builds; callers fall back to stream reading
+bool MappedFile::open(const std::string& /*filename*/) {
+    return false;
+}
+
+void MappedFile::close() {
+    addr = nullptr;
+    length = 0;
+}
+
+#endif
@@ -1,21 +1,56 @@
 #include "json_parser.h"
 #include <cctype>
+#include <string>
 #include <utility>
 
 ReadingList JsonParser::parseJsonLine(const std::string& line) {
     ReadingList readings;
-    readings.reserve(4);  // Most lines have 1-4 readings
+    
+    // Views are per-thread scratch space; only the Readings are returned
+    static thread_local JsonLineViews views;
+    parseJsonLineViews(line, views);
+    
+    readings.resize(views.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        toReading(views[i], readings[i]);
+    }
+    return readings;
+}
+
+void JsonParser::toReading(const JsonLineViews::Object& object, Reading& reading) {
+    reading.clear();
+    reading.reserve(object.size());
+    for (const auto& field : object) {
+        reading.emplace(field.key, field.value);
+    }
+}
+
+void JsonParser::toReading(const JsonLineViews::Object& object, Reading& reading, const ColumnProjection& columns) {
+    if (columns.keepsAll()) {
+        toReading(object, reading);
+        return;
+    }
+    reading.clear();
+    for (const auto& field : object) {
+        if (columns.keeps(field.key)) {
+            reading.emplace(field.key, field.value);
+        }
+    }
+}
+
+void JsonParser::parseJsonLineViews(std::string_view line, JsonLineViews& out) {
+    out.clear();
     
     // Find the main object or array
     size_t start = line.find('{');
     bool isArray = false;
-    if (start == std::string::npos) {
+    if (start == std::string_view::npos) {
         start = line.find('[');
         isArray = true;
     }
     
-    if (start == std::string::npos) {
-        return readings;
+    if (start == std::string_view::npos) {
+        return;
     }
     
     size_t pos = start;
@@ -34,7 +69,7 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
     
     while (pos < line.length()) {
         // Find start of next top-level object
-        size_t objStart = std::string::npos;
+        size_t objStart = std::string_view::npos;
         size_t searchPos = pos;
         
         while (searchPos < line.length()) {
@@ -65,11 +100,10 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
             searchPos++;
         }
         
-        if (objStart == std::string::npos) break;
+        if (objStart == std::string_view::npos) break;
         
         pos = objStart + 1;
-        Reading current;
-        current.reserve(8);  // Most readings have ~5-8 fields
+        size_t objectBegin = out.fields.size();
         
         // Parse key-value pairs for this object
         while (pos < line.length()) {
@@ -84,7 +118,7 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
             
             // Find key (handle escaped quotes)
             size_t keyStart = line.find('"', pos);
-            if (keyStart == std::string::npos || keyStart >= line.length()) break;
+            if (keyStart == std::string_view::npos || keyStart >= line.length()) break;
             
             size_t keyEnd = keyStart + 1;
             while (keyEnd < line.length()) {
@@ -98,18 +132,20 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
             }
             if (keyEnd >= line.length()) break;
             
-            std::string key = line.substr(keyStart + 1, keyEnd - keyStart - 1);
+            std::string_view key = line.substr(keyStart + 1, keyEnd - keyStart - 1);
             
             // Find colon
             size_t colon = line.find(':', keyEnd);
-            if (colon == std::string::npos) break;
+            if (colon == std::string_view::npos) break;
             
             // Find value
             size_t valueStart = colon + 1;
             while (valueStart < line.length() && isspace(line[valueStart])) valueStart++;
             
-            std::string value;
-            if (line[valueStart] == '"') {
+            // A missing value at end of line falls through to the scalar branch
+            char first = valueStart < line.length() ? line[valueStart] : '\0';
+            std::string_view value;
+            if (first == '"') {
                 // String value - handle escaped quotes
                 size_t i = valueStart + 1;
                 while (i < line.length()) {
@@ -124,7 +160,7 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
                 if (i >= line.length()) break;
                 value = line.substr(valueStart + 1, i - valueStart - 1);
                 pos = i + 1;
-            } else if (line[valueStart] == '[') {
+            } else if (first == '[') {
                 // Array value - find matching ], respecting nesting and strings
                 int depth = 1;
                 bool inString = false;
@@ -145,7 +181,7 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
                 }
                 value = line.substr(valueStart + 1, i - valueStart - 2);
                 pos = i;
-            } else if (line[valueStart] == '{') {
+            } else if (first == '{') {
                 // Nested object value - find matching }, respecting nesting and strings
                 int depth = 1;
                 bool inString = false;
@@ -169,19 +205,19 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
             } else {
                 // Numeric or other value
                 size_t valueEnd = line.find_first_of(",}]", valueStart);
-                if (valueEnd == std::string::npos) valueEnd = line.length();
+                if (valueEnd == std::string_view::npos) valueEnd = line.length();
                 value = line.substr(valueStart, valueEnd - valueStart);
                 // Trim whitespace
                 size_t end = value.find_last_not_of(" \t\n\r");
-                if (end != std::string::npos) value = value.substr(0, end + 1);
+                if (end != std::string_view::npos) value = value.substr(0, end + 1);
                 pos = valueEnd;
             }
             
-            current.emplace(std::move(key), std::move(value));
+            out.fields.push_back({key, value});
         }
         
-        if (!current.empty()) {
-            readings.push_back(std::move(current));
+        if (out.fields.size() > objectBegin) {
+            out.bounds.emplace_back(objectBegin, out.fields.size());
         }
         
         // Reset outer tracking state after parsing an object
@@ -196,6 +232,4 @@ ReadingList JsonParser::parseJsonLine(const std::string& line) {
             break;
         }
     }
-    
-    return readings;
 }
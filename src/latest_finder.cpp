@@ -50,6 +50,7 @@ LatestFinder::LatestFinder(int argc, char* argv[]) : limitRows(0), outputFormat(
     }
     
     copyFromParser(parser);
+    requireColumns({Keys::SensorId.str(), Keys::Timestamp.str()});
 }
 
 void LatestFinder::usage() {
@@ -63,6 +64,8 @@ void LatestFinder::usage() {
               << "  -if, --input-format <fmt>  Input format: json (default) or csv\n"
               << "  --tail <n>         Only read last n lines from each file\n"
               << "  --tail-column-value <col:val> <n>  Return last n rows where column=value\n"
+              << "  -j, --jobs <n>     Worker threads (default: number of CPU cores)\n"
+              << "  --io-jobs <n>      Maximum files read at once (default: no limit)\n"
               << "  -v, --verbose      Show verbose output\n"
               << "  -h, --help         Show this help message\n"
               << "\nOutput columns: sensor_id, unix_timestamp, iso_date\n";
@@ -90,7 +93,7 @@ int LatestFinder::main() {
             // Filtering already done by DataReader
             
             // Get sensor_id
-            auto sensorIt = reading.find("sensor_id");
+            auto sensorIt = reading.find(Keys::SensorId);
             if (sensorIt == reading.end() || sensorIt->second.empty()) {
                 return;
             }
@@ -124,7 +127,7 @@ int LatestFinder::main() {
     
     std::map<std::string, SensorLatest> latestBySensor = 
         processFilesParallel(inputFiles, processFile, combineLatest, 
-                             std::map<std::string, SensorLatest>());
+                             std::map<std::string, SensorLatest>(), jobs);
     
     // Convert to vector for sorting and limiting
     std::vector<SensorLatest> results;
@@ -2,6 +2,7 @@
 #include "data_reader.h"
 #include "file_collector.h"
 #include "date_utils.h"
+#include "numeric_utils.h"
 
 #include <vector>
 #include <string>
@@ -48,20 +49,16 @@ sensor_data_result_t *sensor_data_tail_by_sensor_id(
     for (const auto& file : files) {
         reader.processFile(file, [&](const Reading& reading, int, const std::string&) {
             // Extract value
-            auto valueIt = reading.find("value");
+            auto valueIt = reading.find(Keys::Value);
             if (valueIt == reading.end()) return;
             
-            double val;
-            try {
-                val = std::stod(valueIt->second);
-            } catch (...) {
-                return; // Skip non-numeric values
-            }
+            auto val = NumericUtils::parseDoublePrefix(valueIt->second);
+            if (!val) return; // Skip non-numeric values
             
             // Extract timestamp if available
             long ts = static_cast<long>(DateUtils::getTimestamp(reading));
             
-            allValues.push_back({val, ts});
+            allValues.push_back({*val, ts});
         });
     }
     
@@ -174,17 +171,13 @@ sensor_data_result_t *sensor_data_range_by_sensor_id_ext(
             if (ts < start_time || ts > end_time) return;
             
             // Extract value
-            auto valueIt = reading.find("value");
+            auto valueIt = reading.find(Keys::Value);
             if (valueIt == reading.end()) return;
             
-            double val;
-            try {
-                val = std::stod(valueIt->second);
-            } catch (...) {
-                return; // Skip non-numeric values
-            }
+            auto val = NumericUtils::parseDoublePrefix(valueIt->second);
+            if (!val) return; // Skip non-numeric values
             
-            allValues.push_back({val, ts});
+            allValues.push_back({*val, ts});
         });
     }
     
@@ -259,18 +252,14 @@ sensor_data_result_t *sensor_data_head_by_sensor_id(
     
     for (const auto& file : files) {
         reader.processFile(file, [&](const Reading& reading, int, const std::string&) {
-            auto valueIt = reading.find("value");
+            auto valueIt = reading.find(Keys::Value);
             if (valueIt == reading.end()) return;
             
-            double val;
-            try {
-                val = std::stod(valueIt->second);
-            } catch (...) {
-                return;
-            }
+            auto val = NumericUtils::parseDoublePrefix(valueIt->second);
+            if (!val) return;
             
             long ts = static_cast<long>(DateUtils::getTimestamp(reading));
-            allValues.push_back({val, ts});
+            allValues.push_back({*val, ts});
         });
     }
     
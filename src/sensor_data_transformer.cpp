@@ -1,10 +1,16 @@
 #include "sensor_data_transformer.h"
 #include "data_reader.h"
 #include "rdata_writer.h"
+#include "row_spill.h"
+#include "seen_row_set.h"
 #include <fstream>
-#include <future>
+#include <sstream>
 #include <cstdio>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <streambuf>
 
 // ===== Private helper methods =====
 
@@ -61,6 +67,20 @@ void SensorDataTransformer::collectKeysFromFile(const std::string& filename) {
     }
     
     std::set<std::string> localKeys;
+    SchemaCache::Stamp stamp;
+    if (schemaCache) {
+        stamp = SchemaCache::stampOf(filename);
+        if (schemaCache->lookup(filename, stamp, localKeys)) {
+            if (verbosity >= 2) {
+                std::lock_guard<std::mutex> outputLock(outputMutex);
+                std::cout << "  Keys for " << filename << " taken from schema cache" << std::endl;
+            }
+            std::lock_guard<std::mutex> lock(keysMutex);
+            allKeys.insert(localKeys.begin(), localKeys.end());
+            return;
+        }
+    }
+    
     DataReader reader = createDataReader(rejectMode);
     
     reader.processFile(filename, [&](const Reading& reading, 
@@ -70,6 +90,10 @@ void SensorDataTransformer::collectKeysFromFile(const std::string& filename) {
         }
     });
     
+    if (schemaCache) {
+        schemaCache->store(filename, stamp, localKeys);
+    }
+    
     // Merge into global keys with mutex
     {
         std::lock_guard<std::mutex> lock(keysMutex);
@@ -81,6 +105,30 @@ void SensorDataTransformer::collectKeysFromFile(const std::string& filename) {
     }
 }
 
+std::string SensorDataTransformer::schemaSignature() const {
+    std::ostringstream sig;
+    sig << inputFormat << '\n' << minDate << ' ' << maxDate << '\n'
+        << removeErrors << removeEmptyJson << rejectMode << '\n'
+        << tailLines << ' ' << tailColumnValueColumn << '\x1f' << tailColumnValueValue
+        << '\x1f' << tailColumnValueCount << '\n';
+    for (const auto& column : notEmptyColumns) sig << column << '\x1f';
+    sig << '\n';
+    for (const auto& column : notNullColumns) sig << column << '\x1f';
+    sig << '\n';
+    for (const auto* filters : {&onlyValueFilters, &excludeValueFilters, &allowedValues}) {
+        for (const auto& [column, values] : *filters) {
+            sig << column << '\x1e';
+            for (const auto& value : values) sig << value << '\x1f';
+        }
+        sig << '\n';
+    }
+    for (const auto& rule : updateRules) {
+        sig << rule.matchColumn << '\x1f' << rule.matchValue << '\x1f' << rule.targetColumn
+            << '\x1f' << rule.newValue << '\x1f' << rule.onlyWhenEmpty << '\x1e';
+    }
+    return sig.str();
+}
+
 void SensorDataTransformer::writeRowsFromFile(const std::string& filename, std::ostream& outfile, 
                                                const std::vector<std::string>& headers, DataReader& reader) {
     if (verbosity >= 1) {
@@ -91,6 +139,10 @@ void SensorDataTransformer::writeRowsFromFile(const std::string& filename, std::
                                       int /*lineNum*/, const std::string& /*source*/) {
         // Filtering already done by DataReader
         if (reading.empty()) return;
+        if (spillRows) {
+            spillRow(reading, outfile, spilledKeys);
+            return;
+        }
         writeRow(reading, headers, outfile);
     });
 }
@@ -118,30 +170,489 @@ void SensorDataTransformer::writeRowsFromFileJson(const std::string& filename, s
     });
 }
 
-void SensorDataTransformer::processStdinData(const ReadingList& readings, 
-                                              const std::vector<std::string>& headers, 
-                                              std::ostream& outfile) {
-    // Readings are already filtered by DataReader
-    for (const auto& reading : readings) {
-        if (reading.empty()) continue;
-        writeRow(reading, headers, outfile);
+namespace {
+
+// Stream buffer appending to a string, so formatted rows can be moved out
+// instead of copied as std::ostringstream::str() would
+class StringAppendBuf : public std::streambuf {
+public:
+    explicit StringAppendBuf(std::string& text) : text(text) {}
+    
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) text.push_back(static_cast<char>(c));
+        return c;
     }
+    
+    std::streamsize xsputn(const char* data, std::streamsize n) override {
+        text.append(data, static_cast<size_t>(n));
+        return n;
+    }
+    
+private:
+    std::string& text;
+};
+
+} // namespace
+
+void SensorDataTransformer::writeFilesParallel(std::ostream& outfile,
+                                                const std::vector<std::string>& headers,
+                                                bool& firstOutput) {
+    // Formatted rows held for files whose turn hasn't come, across all files
+    static constexpr size_t MAX_BUFFERED_BYTES = 32 * 1024 * 1024;
+    // Batch size: how much a worker formats between checks on its turn
+    static constexpr size_t FLUSH_BYTES = 1024 * 1024;
+    
+    const bool json = (outputFormat == "json");
+    const char* sp = removeWhitespace ? "" : " ";
+    
+    // Workers filter without --unique or updates; both are applied through
+    // this filter so duplicates are judged on the reading before updates and
+    // the first occurrence in file order wins, as in the sequential pass
+    ReadingFilter sharedFilter = createFilter(rejectMode);
+    const bool unique = sharedFilter.isUniqueRows();
+    const bool hasUpdates = !updateRules.empty();
+    
+    // Files are taken strictly in order, so the head is always being read
+    // and never waits for room; with --io-jobs, no more workers than files
+    // may be open, so none of them waits for a slot while holding room
+    size_t workers = std::min(inputFiles.size(), ThreadPool::shared().size());
+    if (size_t maxOpen = DataReader::maxOpenFiles()) workers = std::min(workers, maxOpen);
+    
+    // --unique-memory: half the budget for the shared seen set, the other
+    // half shared out between the workers' per-file sets
+    size_t fileSeenBudget = 0;
+    if (unique && uniqueMemoryMB > 0) {
+        size_t budget = static_cast<size_t>(uniqueMemoryMB) * 1024 * 1024;
+        sharedFilter.setUniqueMemoryLimit(budget / 2);
+        fileSeenBudget = std::max<size_t>(budget / 2 / workers, 1);
+    }
+    
+    // Formatted rows, cut into batches of about FLUSH_BYTES
+    struct RowBatch {
+        std::string text;               // formatted rows, back to back
+        std::vector<size_t> rowEnds;    // end offset of each row in text
+        std::vector<ReadingFilter::UniqueKey> uniqueKeys;  // --unique key of each row
+        std::unordered_set<FieldKey> fieldKeys;  // columns seen, when spilling
+        
+        size_t bytes() const {
+            size_t total = text.capacity() + rowEnds.capacity() * sizeof(size_t) +
+                           uniqueKeys.capacity() * sizeof(ReadingFilter::UniqueKey);
+            for (const auto& key : uniqueKeys) {
+                if (!key.row.empty()) total += key.row.capacity();  // --unique-exact
+            }
+            return total;
+        }
+    };
+    
+    // A file that finished before its turn came
+    struct WaitingFile {
+        std::vector<RowBatch> batches;
+        size_t bytes;  // counted in buffered
+    };
+    
+    // Only the file at the head of the output writes, so this needs no lock:
+    // claims --unique keys in file order, writes the rows that win and
+    // empties the batch for reuse
+    auto writeBatch = [&](RowBatch& batch) {
+        spilledKeys.insert(batch.fieldKeys.begin(), batch.fieldKeys.end());
+        size_t start = 0;
+        for (size_t row = 0; row < batch.rowEnds.size(); ++row) {
+            size_t end = batch.rowEnds[row];
+            if (!unique || sharedFilter.claimUniqueKey(std::move(batch.uniqueKeys[row]))) {
+                if (json) {
+                    if (!firstOutput) outfile << "\n";
+                    firstOutput = false;
+                }
+                outfile.write(batch.text.data() + start, static_cast<std::streamsize>(end - start));
+            }
+            start = end;
+        }
+        batch.text.clear();
+        batch.rowEnds.clear();
+        batch.uniqueKeys.clear();
+        batch.fieldKeys.clear();
+    };
+    
+    // Stands in for the notes the workers' silenced readers would print
+    auto announceFile = [&](const std::string& filename) {
+        if (verbosity < 1) return;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        // Printed twice on purpose: the sequential pass prints this line
+        // itself and DataReader::processFile() prints it again
+        (json ? std::cerr : std::cout) << "Processing file: " << filename << std::endl;
+        std::cout << "Processing file: " << filename << std::endl;
+        if (tailLines > 0) {
+            std::cout << "  (reading last " << tailLines << " lines only)" << std::endl;
+        }
+        if (tailColumnValueCount > 0) {
+            std::cerr << "  (finding last " << tailColumnValueCount << " rows where "
+                      << tailColumnValueColumn << "=" << tailColumnValueValue << ")" << std::endl;
+        }
+    };
+    
+    std::mutex sequenceMutex;
+    std::condition_variable turnOrRoom;
+    std::vector<std::unique_ptr<WaitingFile>> waitingFiles(inputFiles.size());
+    size_t nextToWrite = 0;  // the head of the output
+    size_t buffered = 0;     // batch bytes held for files that are not the head
+    
+    // Called with sequenceMutex held once the head file is done: write the
+    // finished files queued behind it and hand the turn to the next one
+    auto advance = [&]() {
+        ++nextToWrite;
+        while (nextToWrite < waitingFiles.size() && waitingFiles[nextToWrite]) {
+            announceFile(inputFiles[nextToWrite]);
+            buffered -= waitingFiles[nextToWrite]->bytes;
+            for (auto& batch : waitingFiles[nextToWrite]->batches) writeBatch(batch);
+            waitingFiles[nextToWrite].reset();
+            ++nextToWrite;
+        }
+        if (nextToWrite < waitingFiles.size()) {
+            announceFile(inputFiles[nextToWrite]);
+        }
+        turnOrRoom.notify_all();
+    };
+    
+    auto processFile = [&](size_t index) {
+        RowBatch batch;
+        StringAppendBuf sink(batch.text);
+        std::ostream buffer(&sink);
+        std::vector<RowBatch> held;  // full batches waiting for our turn
+        size_t heldBytes = 0;
+        bool head = false;
+        SeenRowSet seenInFile;  // a later copy in this file is never the first
+        seenInFile.setMemoryLimit(fileSeenBudget);
+        Reading updated;
+        
+        // Write the batch if it is our turn; otherwise hold it, counted
+        // against the limit, and wait while the limit is reached
+        auto flush = [&]() {
+            if (head) {
+                writeBatch(batch);
+                return;
+            }
+            size_t bytes = batch.bytes();
+            held.push_back(std::move(batch));
+            batch = RowBatch();
+            
+            std::unique_lock<std::mutex> lock(sequenceMutex);
+            buffered += bytes;
+            heldBytes += bytes;
+            turnOrRoom.wait(lock, [&]() { return nextToWrite == index || buffered <= MAX_BUFFERED_BYTES; });
+            if (nextToWrite != index) return;
+            head = true;
+            buffered -= heldBytes;
+            turnOrRoom.notify_all();
+            lock.unlock();
+            
+            for (auto& waiting : held) writeBatch(waiting);
+            held.clear();
+            heldBytes = 0;
+        };
+        
+        DataReader reader = createDeferredUniqueReader(rejectMode);
+        
+        // announceFile() prints the per-file notes in file order instead
+        reader.setVerbosity(0);
+        reader.getFilter().setVerbosity(verbosity);
+        
+        reader.processFile(inputFiles[index], [&](const Reading& reading,
+                                                   int /*lineNum*/, const std::string& /*source*/) {
+            if (reading.empty()) return;
+            
+            if (unique) {
+                ReadingFilter::UniqueKey key = sharedFilter.uniqueKey(reading);
+                bool newInFile = uniqueExact ? seenInFile.insert(key.fingerprint, key.row)
+                                             : seenInFile.insert(key.fingerprint);
+                if (!newInFile) {
+                    if (verbosity >= 2) {
+                        std::cerr << "  Skipping row: duplicate" << std::endl;
+                    }
+                    return;
+                }
+                batch.uniqueKeys.push_back(std::move(key));
+            }
+            
+            const Reading* row = &reading;
+            if (hasUpdates) {
+                updated = reading;
+                sharedFilter.applyTransformations(updated);
+                row = &updated;
+            }
+            
+            if (json) {
+                buffer << "[" << sp;
+                writeJsonObject(*row, buffer, removeWhitespace);
+                buffer << sp << "]";
+            } else if (spillRows) {
+                spillRow(*row, buffer, batch.fieldKeys);
+            } else {
+                writeCsvRow(*row, headers, buffer);
+            }
+            batch.rowEnds.push_back(batch.text.size());
+            
+            if (batch.text.size() >= FLUSH_BYTES) flush();
+        });
+        
+        std::lock_guard<std::mutex> lock(sequenceMutex);
+        if (nextToWrite == index) {
+            buffered -= heldBytes;
+            for (auto& waiting : held) writeBatch(waiting);
+            writeBatch(batch);
+            advance();
+        } else {
+            size_t bytes = batch.bytes();
+            held.push_back(std::move(batch));
+            buffered += bytes;
+            waitingFiles[index] = std::make_unique<WaitingFile>(WaitingFile{std::move(held), heldBytes + bytes});
+        }
+    };
+    
+    std::atomic<size_t> nextFile{0};
+    
+    announceFile(inputFiles[0]);
+    ThreadPool::shared().forEach(workers, [&](size_t) {
+        for (size_t index = nextFile++; index < inputFiles.size(); index = nextFile++) {
+            processFile(index);
+        }
+    });
 }
 
-void SensorDataTransformer::processStdinDataJson(const ReadingList& readings, 
-                                                  std::ostream& outfile) {
+void SensorDataTransformer::writeRows(std::ostream& outfile, const std::vector<std::string>& headers) {
+    if (outputFormat != "json") {
+        for (size_t i = 0; i < headers.size(); ++i) {
+            if (i > 0) outfile << ",";
+            outfile << headers[i];
+        }
+        outfile << "\n";
+    }
+    
     bool firstOutput = true;
-    const char* sp = removeWhitespace ? "" : " ";
+    writeFileRows(outfile, headers, firstOutput);
+    
+    if (outputFormat == "json") {
+        outfile << "\n";
+    }
+}
+
+void SensorDataTransformer::writeFileRows(std::ostream& outfile, const std::vector<std::string>& headers,
+                                           bool& firstOutput) {
+    if (!readsSequentially(inputFiles.size(), jobs)) {
+        writeFilesParallel(outfile, headers, firstOutput);
+        return;
+    }
     
-    // Readings are already filtered by DataReader
-    for (const auto& reading : readings) {
-        if (reading.empty()) continue;
+    // Create a single reader to share across all files (for --unique tracking)
+    DataReader reader = createDataReader(rejectMode);
+    for (const auto& file : inputFiles) {
+        if (outputFormat == "json") {
+            writeRowsFromFileJson(file, outfile, firstOutput, reader);
+        } else {
+            writeRowsFromFile(file, outfile, headers, reader);
+        }
+    }
+}
+
+void SensorDataTransformer::spillRow(const Reading& reading, std::ostream& spill,
+                                      std::unordered_set<FieldKey>& keys) {
+    RowSpill::encode(reading, spill);
+    for (const auto& field : reading) {
+        keys.insert(field.first);
+    }
+}
+
+void SensorDataTransformer::transformSinglePass() {
+    std::ofstream fileOut;
+    if (!outputFile.empty()) {
+        fileOut.open(outputFile);
+        if (!fileOut) {
+            std::cerr << "Error: Cannot create output file: " << outputFile << std::endl;
+            return;
+        }
+    }
+    std::ostream& outfile = outputFile.empty() ? std::cout : fileOut;
+    
+    if (outputFormat == "json") {
+        if (verbosity >= 1) {
+            std::cerr << "Single pass: Writing json..." << std::endl;
+        }
+        writeRows(outfile, {});
+    } else {
+        if (verbosity >= 1) {
+            std::cerr << "Single pass: Spilling rows while discovering columns..." << std::endl;
+        }
+        RowSpill spill;
+        if (!spill.isOpen()) {
+            std::cerr << "Error: Cannot create temporary file for --single-pass" << std::endl;
+            return;
+        }
         
-        if (!firstOutput) outfile << "\n";
-        firstOutput = false;
-        outfile << "[" << sp;
-        writeJsonObject(reading, outfile, removeWhitespace);
-        outfile << sp << "]";
+        bool firstOutput = true;
+        spillRows = true;
+        writeFileRows(spill.stream(), {}, firstOutput);
+        spillRows = false;
+        
+        for (FieldKey key : spilledKeys) {
+            allKeys.insert(key.str());
+        }
+        std::cerr << "Found " << allKeys.size() << " unique fields" << std::endl;
+        
+        std::vector<std::string> headers(allKeys.begin(), allKeys.end());
+        std::sort(headers.begin(), headers.end());
+        for (size_t i = 0; i < headers.size(); ++i) {
+            if (i > 0) outfile << ",";
+            outfile << headers[i];
+        }
+        outfile << "\n";
+        
+        bool replayed = spill.replay([&](const Reading& reading) {
+            writeCsvRow(reading, headers, outfile);
+        });
+        if (!replayed) {
+            std::cerr << "Error: Failed to read back temporary file for --single-pass" << std::endl;
+            return;
+        }
+    }
+    
+    if (!outputFile.empty()) {
+        fileOut.close();
+        if (verbosity >= 1) {
+            std::cerr << "Wrote " << outputFormat << " to " << outputFile << std::endl;
+        }
+    }
+}
+
+void SensorDataTransformer::transformStdin() {
+    // Reading from stdin - use DataReader for ALL parsing and filtering
+    if (verbosity >= 1) {
+        std::cerr << "Reading from stdin (format: " << inputFormat << ")..." << std::endl;
+    }
+    printFilterInfo();
+    
+    // Create DataReader configured with all filters
+    DataReader reader = createDataReader(rejectMode);
+    
+    if (outputFormat == "rdata" || outputFormat == "rds") {
+        // RData/RDS requires a file output
+        if (outputFile.empty()) {
+            std::cerr << "Error: RData/RDS output requires -o/--output file" << std::endl;
+            return;
+        }
+        
+        // The R formats are written column by column, so hold everything
+        ReadingList stdinReadings = reader.collectFromStdin();
+        if (stdinReadings.empty()) {
+            std::cerr << "Error: No input data" << std::endl;
+            return;
+        }
+        
+        for (const auto& reading : stdinReadings) {
+            for (const auto& [key, value] : reading) {
+                allKeys.insert(key);
+            }
+        }
+        std::vector<std::string> headers(allKeys.begin(), allKeys.end());
+        std::sort(headers.begin(), headers.end());
+        
+        bool success;
+        if (outputFormat == "rdata") {
+            success = RDataWriter::writeRData(outputFile, stdinReadings, headers);
+        } else {
+            success = RDataWriter::writeRDS(outputFile, stdinReadings, headers);
+        }
+        
+        if (success && verbosity >= 1) {
+            std::cerr << "Wrote " << stdinReadings.size() << " rows to " << outputFile << std::endl;
+        }
+        return;
+    }
+    
+    // The output file is only created once there is data to write
+    std::ofstream fileOut;
+    auto openOutput = [&]() -> std::ostream* {
+        if (outputFile.empty()) return &std::cout;
+        fileOut.open(outputFile);
+        if (!fileOut) {
+            std::cerr << "Error: Cannot create output file: " << outputFile << std::endl;
+            return nullptr;
+        }
+        return &fileOut;
+    };
+    
+    size_t readingCount = 0;
+    std::ostream* outfile = nullptr;
+    
+    if (outputFormat == "json") {
+        // JSON rows need no column set, so write each one as it arrives
+        const char* sp = removeWhitespace ? "" : " ";
+        bool firstOutput = true;
+        reader.processStdin([&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
+            if (readingCount++ == 0) {
+                outfile = openOutput();
+            }
+            if (!outfile || reading.empty()) return;
+            
+            if (!firstOutput) *outfile << "\n";
+            firstOutput = false;
+            *outfile << "[" << sp;
+            writeJsonObject(reading, *outfile, removeWhitespace);
+            *outfile << sp << "]";
+        });
+        
+        if (readingCount == 0) {
+            std::cerr << "Error: No input data" << std::endl;
+            return;
+        }
+        if (!outfile) return;
+        *outfile << "\n";
+    } else {
+        // CSV needs every column before the first row: spill rows to a
+        // temporary file so memory use does not grow with the input
+        RowSpill spill;
+        if (!spill.isOpen()) {
+            std::cerr << "Error: Cannot create temporary file for stdin" << std::endl;
+            return;
+        }
+        reader.processStdin([&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
+            readingCount++;
+            if (!reading.empty()) {
+                spillRow(reading, spill.stream(), spilledKeys);
+            }
+        });
+        
+        if (readingCount == 0) {
+            std::cerr << "Error: No input data" << std::endl;
+            return;
+        }
+        outfile = openOutput();
+        if (!outfile) return;
+        
+        for (FieldKey key : spilledKeys) {
+            allKeys.insert(key.str());
+        }
+        std::vector<std::string> headers(allKeys.begin(), allKeys.end());
+        std::sort(headers.begin(), headers.end());
+        for (size_t i = 0; i < headers.size(); ++i) {
+            if (i > 0) *outfile << ",";
+            *outfile << headers[i];
+        }
+        *outfile << "\n";
+        
+        bool replayed = spill.replay([&](const Reading& reading) {
+            writeCsvRow(reading, headers, *outfile);
+        });
+        if (!replayed) {
+            std::cerr << "Error: Failed to read back temporary file for stdin" << std::endl;
+            return;
+        }
+    }
+    
+    if (!outputFile.empty()) {
+        fileOut.close();
+        if (verbosity >= 1) {
+            std::cerr << "Wrote " << outputFormat << " to " << outputFile << std::endl;
+        }
     }
 }
 
@@ -162,8 +673,9 @@ SensorDataTransformer::SensorDataTransformer(int argc, char* argv[], bool reject
     : outputFormat("")
     , removeWhitespace(false)
     , rejectMode(rejectModeParam)
-    , numThreads(4)
-    , usePrototype(false) {
+    , usePrototype(false)
+    , singlePass(false)
+    , spillRows(false) {
     
     // Check for help flag first
     for (int i = 1; i < argc; ++i) {
@@ -188,6 +700,16 @@ SensorDataTransformer::SensorDataTransformer(int argc, char* argv[], bool reject
             usePrototype = true;
         } else if (arg == "--remove-whitespace") {
             removeWhitespace = true;
+        } else if (arg == "--single-pass") {
+            singlePass = true;
+        } else if (arg == "--schema-cache") {
+            if (i + 1 < argc) {
+                ++i;
+                schemaCacheDir = argv[i];
+            } else {
+                std::cerr << "Error: " << arg << " requires an argument" << std::endl;
+                exit(1);
+            }
         } else if (arg == "-o" || arg == "--output") {
             if (i + 1 < argc) {
                 ++i;
@@ -219,9 +741,9 @@ SensorDataTransformer::SensorDataTransformer(int argc, char* argv[], bool reject
         exit(1);
     }
     
-    // Check for unknown options (transform-specific: -o, --output, -of, --output-format, --use-prototype, --remove-whitespace)
+    // Check for unknown options (transform-specific: -o, --output, -of, --output-format, --use-prototype, --remove-whitespace, --single-pass, --schema-cache)
     std::string unknownOpt = CommonArgParser::checkUnknownOptions(argc, argv, 
-        {"-o", "--output", "-of", "--output-format", "--use-prototype", "--remove-whitespace"});
+        {"-o", "--output", "-of", "--output-format", "--use-prototype", "--remove-whitespace", "--single-pass", "--schema-cache"});
     if (!unknownOpt.empty()) {
         std::cerr << "Error: Unknown option '" << unknownOpt << "'" << std::endl;
         printTransformUsage(argv[0]);
@@ -258,88 +780,7 @@ void SensorDataTransformer::transform() {
     }
     
     if (inputFiles.empty()) {
-        // Reading from stdin - use DataReader for ALL parsing and filtering
-        if (verbosity >= 1) {
-            std::cerr << "Reading from stdin (format: " << inputFormat << ")..." << std::endl;
-        }
-        printFilterInfo();
-        
-        // Create DataReader configured with all filters
-        DataReader reader = createDataReader(rejectMode);
-        
-        // Collect all filtered readings from stdin
-        // DataReader handles all parsing (CSV/JSON) and filtering
-        ReadingList stdinReadings = reader.collectFromStdin();
-        
-        if (stdinReadings.empty()) {
-            std::cerr << "Error: No input data" << std::endl;
-            return;
-        }
-        
-        // Collect all keys from filtered readings (for CSV headers)
-        for (const auto& reading : stdinReadings) {
-            for (const auto& [key, value] : reading) {
-                allKeys.insert(key);
-            }
-        }
-        
-        std::vector<std::string> headers(allKeys.begin(), allKeys.end());
-        std::sort(headers.begin(), headers.end());
-        
-        // Output the data
-        if (outputFormat == "rdata" || outputFormat == "rds") {
-            // RData/RDS requires a file output
-            if (outputFile.empty()) {
-                std::cerr << "Error: RData/RDS output requires -o/--output file" << std::endl;
-                return;
-            }
-            
-            bool success;
-            if (outputFormat == "rdata") {
-                success = RDataWriter::writeRData(outputFile, stdinReadings, headers);
-            } else {
-                success = RDataWriter::writeRDS(outputFile, stdinReadings, headers);
-            }
-            
-            if (success && verbosity >= 1) {
-                std::cerr << "Wrote " << stdinReadings.size() << " rows to " << outputFile << std::endl;
-            }
-        } else if (outputFile.empty()) {
-            if (outputFormat == "json") {
-                processStdinDataJson(stdinReadings, std::cout);
-                std::cout << "\n";
-            } else {
-                for (size_t i = 0; i < headers.size(); ++i) {
-                    if (i > 0) std::cout << ",";
-                    std::cout << headers[i];
-                }
-                std::cout << "\n";
-                processStdinData(stdinReadings, headers, std::cout);
-            }
-        } else {
-            std::ofstream outfile(outputFile);
-            if (!outfile) {
-                std::cerr << "Error: Cannot create output file: " << outputFile << std::endl;
-                return;
-            }
-            
-            if (outputFormat == "json") {
-                processStdinDataJson(stdinReadings, outfile);
-                outfile << "\n";
-            } else {
-                for (size_t i = 0; i < headers.size(); ++i) {
-                    if (i > 0) outfile << ",";
-                    outfile << headers[i];
-                }
-                outfile << "\n";
-                processStdinData(stdinReadings, headers, outfile);
-            }
-            
-            outfile.close();
-            if (verbosity >= 1) {
-                std::cerr << "Wrote " << outputFormat << " to " << outputFile << std::endl;
-            }
-        }
+        transformStdin();
         return;
     }
     
@@ -347,6 +788,11 @@ void SensorDataTransformer::transform() {
     printCommonVerboseInfo("Starting conversion", verbosity, recursive, extensionFilter, maxDepth, inputFiles.size());
     printFilterInfo();
     
+    if (singlePass && !usePrototype && (outputFormat == "json" || outputFormat == "csv")) {
+        transformSinglePass();
+        return;
+    }
+    
     // PASS 1: Collect all column names
     if (usePrototype) {
         std::cerr << "Using sc-prototype for column definitions..." << std::endl;
@@ -357,22 +803,17 @@ void SensorDataTransformer::transform() {
     } else {
         std::cerr << "Pass 1: Discovering columns..." << std::endl;
         
-        size_t filesPerThread = std::max(size_t(1), inputFiles.size() / numThreads);
-        std::vector<std::future<void>> futures;
-        futures.reserve(numThreads);
-        
-        for (size_t i = 0; i < inputFiles.size(); i += filesPerThread) {
-            size_t end = std::min(i + filesPerThread, inputFiles.size());
-            
-            futures.push_back(std::async(std::launch::async, [this, i, end]() {
-                for (size_t j = i; j < end; ++j) {
-                    collectKeysFromFile(inputFiles[j]);
-                }
-            }));
+        if (!schemaCacheDir.empty()) {
+            schemaCache = std::make_unique<SchemaCache>(schemaCacheDir, schemaSignature());
+            schemaCache->load();
         }
         
-        for (auto& f : futures) {
-            f.wait();
+        processFilesParallelVoid(inputFiles, [this](const std::string& file) {
+            collectKeysFromFile(file);
+        }, jobs);
+        
+        if (schemaCache && !schemaCache->save()) {
+            std::cerr << "Warning: Could not write schema cache in " << schemaCacheDir << std::endl;
         }
         
         std::cerr << "Found " << allKeys.size() << " unique fields" << std::endl;
@@ -447,26 +888,7 @@ void SensorDataTransformer::transform() {
             std::cerr << "Pass 2: Writing " << outputFormat << " to stdout..." << std::endl;
         }
         
-        // Create a single reader to share across all files (for --unique tracking)
-        DataReader reader = createDataReader(rejectMode);
-        
-        if (outputFormat == "json") {
-            bool firstOutput = true;
-            for (const auto& file : inputFiles) {
-                writeRowsFromFileJson(file, std::cout, firstOutput, reader);
-            }
-            std::cout << "\n";
-        } else {
-            for (size_t i = 0; i < headers.size(); ++i) {
-                if (i > 0) std::cout << ",";
-                std::cout << headers[i];
-            }
-            std::cout << "\n";
-            
-            for (const auto& file : inputFiles) {
-                writeRowsFromFile(file, std::cout, headers, reader);
-            }
-        }
+        writeRows(std::cout, headers);
     } else {
         if (verbosity >= 1) {
             std::cerr << "Pass 2: Writing " << outputFormat << " to file..." << std::endl;
@@ -478,26 +900,7 @@ void SensorDataTransformer::transform() {
             return;
         }
         
-        // Create a single reader to share across all files (for --unique tracking)
-        DataReader reader = createDataReader(rejectMode);
-        
-        if (outputFormat == "json") {
-            bool firstOutput = true;
-            for (const auto& file : inputFiles) {
-                writeRowsFromFileJson(file, outfile, firstOutput, reader);
-            }
-            outfile << "\n";
-        } else {
-            for (size_t i = 0; i < headers.size(); ++i) {
-                if (i > 0) outfile << ",";
-                outfile << headers[i];
-            }
-            outfile << "\n";
-            
-            for (const auto& file : inputFiles) {
-                writeRowsFromFile(file, outfile, headers, reader);
-            }
-        }
+        writeRows(outfile, headers);
         
         outfile.close();
         if (verbosity >= 1) {
@@ -529,7 +932,13 @@ void SensorDataTransformer::printTransformUsage(const char* progName) {
     std::cerr << "  -V                        Very verbose output (show detailed progress)" << std::endl;
     std::cerr << "  -e, --extension <ext>     Filter files by extension (e.g., .out or out)" << std::endl;
     std::cerr << "  -d, --depth <n>           Maximum recursion depth (0 = current dir only)" << std::endl;
+    std::cerr << "  -j, --jobs <n>            Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>             Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  --use-prototype           Use sc-prototype command to define columns" << std::endl;
+    std::cerr << "  --single-pass             Read each input file once; CSV rows are buffered in a" << std::endl;
+    std::cerr << "                            temporary file until all columns are known" << std::endl;
+    std::cerr << "  --schema-cache <dir>      Remember each file's columns in <dir> and skip column" << std::endl;
+    std::cerr << "                            discovery for files unchanged since (size and mtime)" << std::endl;
     std::cerr << "  --not-empty <column>      Skip rows where column is empty (can be used multiple times)" << std::endl;
     std::cerr << "  --only-value <col:val>    Only include rows where column has specific value (can be used multiple times)" << std::endl;
     std::cerr << "  --exclude-value <col:val> Exclude rows where column has specific value (can be used multiple times)" << std::endl;
@@ -537,6 +946,8 @@ void SensorDataTransformer::printTransformUsage(const char* progName) {
     std::cerr << "  --remove-whitespace       Remove extra whitespace from output (compact format)" << std::endl;
     std::cerr << "  --remove-empty-json       Remove empty JSON input lines (e.g., [{}], [])" << std::endl;
     std::cerr << "  --unique                  Only output unique rows (removes duplicates)" << std::endl;
+    std::cerr << "  --unique-exact            Like --unique, but compare whole rows instead of 128-bit hashes" << std::endl;
+    std::cerr << "  --unique-memory <MB>      Like --unique, but keep seen rows within MB of memory, spilling to disk beyond it" << std::endl;
     std::cerr << "  --min-date <date>         Filter readings after this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << "  --max-date <date>         Filter readings before this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << "  --tail-column-value <col:val> <n>" << std::endl;
@@ -587,6 +998,8 @@ void SensorDataTransformer::printListRejectsUsage(const char* progName) {
     std::cerr << "  -V                        Very verbose output (show detailed progress)" << std::endl;
     std::cerr << "  -e, --extension <ext>     Filter files by extension (e.g., .out or out)" << std::endl;
     std::cerr << "  -d, --depth <n>           Maximum recursion depth (0 = current dir only)" << std::endl;
+    std::cerr << "  -j, --jobs <n>            Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>             Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  --not-empty <column>      List rows where column IS empty" << std::endl;
     std::cerr << "  --only-value <col:val>    List rows where column does NOT have this value" << std::endl;
     std::cerr << "  --exclude-value <col:val> List rows where column HAS this value" << std::endl;
@@ -1,36 +1,31 @@
 #include "stats_analyser.h"
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <chrono>
 #include <ctime>
 #include <thread>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
 
 #include "data_reader.h"
+#include "numeric_utils.h"
+#include "percentiles.h"
+#include "seen_row_set.h"
+#include "series_kernels.h"
+#include "thread_pool.h"
 
 // ===== Private static methods =====
 
 bool StatsAnalyser::isNumeric(const std::string& str) {
-    if (str.empty()) return false;
-    try {
-        size_t pos = 0;
-        std::stod(str, &pos);
-        return pos == str.length();
-    } catch (...) {
-        return false;
-    }
+    return NumericUtils::parseDouble(str).has_value();
 }
 
 double StatsAnalyser::calculateMedian(const std::vector<double>& values) {
     if (values.empty()) return 0.0;
-    std::vector<double> sorted = values;
-    std::sort(sorted.begin(), sorted.end());
-    size_t n = sorted.size();
-    if (n % 2 == 0) {
-        return (sorted[n/2 - 1] + sorted[n/2]) / 2.0;
-    } else {
-        return sorted[n/2];
-    }
+    std::vector<double> scratch = values;
+    return Percentiles::select(scratch, {50})[0];
 }
 
 double StatsAnalyser::calculateStdDev(const std::vector<double>& values, double mean) {
@@ -58,14 +53,50 @@ double StatsAnalyser::calculatePercentile(const std::vector<double>& sortedValue
     return sortedValues[lower] + fraction * (sortedValues[upper] - sortedValues[lower]);
 }
 
+// ===== Collected data =====
+
+void StatsAnalyser::CollectedData::addTimestamp(long long ts) {
+    if (streaming) {
+        timeStats.add(ts);
+    } else {
+        timestamps.push_back(ts);
+    }
+}
+
+void StatsAnalyser::CollectedData::addValue(const std::string& column, double value) {
+    if (streaming) {
+        columnStats[column].add(value);
+    } else {
+        columnData[column].push_back(value);
+    }
+}
+
+void StatsAnalyser::CollectedData::append(CollectedData& later) {
+    if (streaming) {
+        for (const auto& [colName, stats] : later.columnStats) {
+            columnStats[colName].append(stats);
+        }
+        timeStats.append(later.timeStats);
+        return;
+    }
+    for (auto& [colName, values] : later.columnData) {
+        auto& target = columnData[colName];
+        if (target.empty()) {
+            target = std::move(values);
+        } else {
+            target.insert(target.end(), values.begin(), values.end());
+        }
+    }
+    timestamps.insert(timestamps.end(), later.timestamps.begin(), later.timestamps.end());
+}
+
 // ===== Private methods =====
 
 void StatsAnalyser::collectDataFromReading(const Reading& reading) {
     // Collect timestamp if present
-    auto tsIt = reading.find("timestamp");
-    if (tsIt != reading.end() && isNumeric(tsIt->second)) {
-        long long ts = std::stoll(tsIt->second);
-        timestamps.push_back(ts);
+    auto tsIt = reading.find(Keys::Timestamp);
+    if (tsIt != reading.end()) {
+        if (auto ts = NumericUtils::parseInteger(tsIt->second)) collected.addTimestamp(*ts);
     }
     
     for (const auto& [colName, colValue] : reading) {
@@ -73,16 +104,17 @@ void StatsAnalyser::collectDataFromReading(const Reading& reading) {
         if (!columnFilter.empty() && colName != columnFilter) continue;
         
         // Try to parse as numeric
-        if (isNumeric(colValue)) {
-            double value = std::stod(colValue);
-            columnData[colName].push_back(value);
+        if (auto number = NumericUtils::parseDouble(colValue)) {
+            collected.addValue(colName, *number);
         }
     }
 }
 
 // ===== Constructor =====
 
-StatsAnalyser::StatsAnalyser(int argc, char* argv[]) : columnFilter("value"), followMode(false) {
+StatsAnalyser::StatsAnalyser(int argc, char* argv[])
+    : columnFilter("value"), byPeriod(false), period(DateUtils::Period::Day), outputFormat("human"),
+      followMode(false), refreshInterval(0), refreshEvery(1), unprintedReadings(0) {
     // Check for help flag first
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -92,16 +124,49 @@ StatsAnalyser::StatsAnalyser(int argc, char* argv[]) : columnFilter("value"), fo
         }
     }
     
-    CommonArgParser parser;
-    if (!parser.parse(argc, argv)) {
-        exit(1);
-    }
-    
-    // Parse StatsAnalyser-specific options (-c/--column and --follow)
-    for (int i = 1; i < argc; ++i) {
+    // Parse StatsAnalyser-specific options (-c/--column and --follow). The
+    // others that take a value are left out of the arguments CommonArgParser
+    // sees, so the values aren't taken for input files.
+    static const std::map<std::string, DateUtils::Period> periodOptions = {
+        {"--by-hour", DateUtils::Period::Hour}, {"--by-day", DateUtils::Period::Day},
+        {"--by-week", DateUtils::Period::Week}, {"--by-month", DateUtils::Period::Month},
+        {"--by-year", DateUtils::Period::Year}};
+    std::vector<char*> filteredArgv;
+    bool formatGiven = false;
+    bool refreshGiven = false;
+    for (int i = 0; i < argc; ++i) {
         std::string arg = argv[i];
         
-        if (arg == "-c" || arg == "--column") {
+        auto periodOption = periodOptions.find(arg);
+        if (periodOption != periodOptions.end()) {
+            if (byPeriod && period != periodOption->second) {
+                std::cerr << "Error: --by-hour, --by-day, --by-week, --by-month, and --by-year are mutually exclusive" << std::endl;
+                exit(1);
+            }
+            byPeriod = true;
+            period = periodOption->second;
+            continue;
+        } else if (arg == "--by-column" || arg == "-b" || arg == "--output-format" || arg == "-of" ||
+                   arg == "--output" || arg == "-o") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << arg << " requires an argument" << std::endl;
+                exit(1);
+            }
+            ++i;
+            if (arg == "--by-column" || arg == "-b") {
+                byColumn = argv[i];
+            } else if (arg == "--output" || arg == "-o") {
+                outputFile = argv[i];
+            } else {
+                outputFormat = argv[i];
+                formatGiven = true;
+                if (outputFormat != "human" && outputFormat != "csv" && outputFormat != "json") {
+                    std::cerr << "Error: --output-format must be 'human', 'csv', or 'json'" << std::endl;
+                    exit(1);
+                }
+            }
+            continue;
+        } else if (arg == "-c" || arg == "--column") {
             if (i + 1 < argc) {
                 ++i;
                 columnFilter = argv[i];
@@ -109,18 +174,58 @@ StatsAnalyser::StatsAnalyser(int argc, char* argv[]) : columnFilter("value"), fo
                 if (columnFilter == "all") {
                     columnFilter = "";
                 }
+                filteredArgv.push_back(argv[i - 1]);
+                filteredArgv.push_back(argv[i]);
+                continue;
             } else {
                 std::cerr << "Error: " << arg << " requires an argument" << std::endl;
                 exit(1);
             }
         } else if (arg == "--follow" || arg == "-f") {
             followMode = true;
+        } else if (arg == "--streaming") {
+            collected.streaming = true;
+        } else if (arg == "--refresh-interval" || arg == "--refresh-every") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << arg << " requires an argument" << std::endl;
+                exit(1);
+            }
+            ++i;
+            refreshGiven = true;
+            double number = -1;
+            try {
+                size_t pos = 0;
+                number = std::stod(argv[i], &pos);
+                if (argv[i][pos] != '\0') number = -1;
+            } catch (...) {
+            }
+            if (arg == "--refresh-interval") {
+                if (!(number >= 0)) {
+                    std::cerr << "Error: --refresh-interval requires a number of seconds" << std::endl;
+                    exit(1);
+                }
+                refreshInterval = number;
+            } else {
+                if (!(number >= 1) || number != std::floor(number)) {
+                    std::cerr << "Error: --refresh-every requires a positive whole number of readings" << std::endl;
+                    exit(1);
+                }
+                refreshEvery = static_cast<size_t>(number);
+            }
+            continue;
         }
+        filteredArgv.push_back(argv[i]);
     }
+    int filteredArgc = static_cast<int>(filteredArgv.size());
     
-    // Check for unknown options (stats-specific: -c/--column, -f/--follow)
-    std::string unknownOpt = CommonArgParser::checkUnknownOptions(argc, argv, 
-        {"-c", "--column", "-f", "--follow"});
+    CommonArgParser parser;
+    if (!parser.parse(filteredArgc, filteredArgv.data())) {
+        exit(1);
+    }
+    
+    // Check for unknown options (stats-specific: -c/--column, -f/--follow, --streaming)
+    std::string unknownOpt = CommonArgParser::checkUnknownOptions(filteredArgc, filteredArgv.data(), 
+        {"-c", "--column", "-f", "--follow", "--streaming"});
     if (!unknownOpt.empty()) {
         std::cerr << "Error: Unknown option '" << unknownOpt << "'" << std::endl;
         printStatsUsage(argv[0]);
@@ -128,12 +233,250 @@ StatsAnalyser::StatsAnalyser(int argc, char* argv[]) : columnFilter("value"), fo
     }
     
     copyFromParser(parser);
+    
+    // Follow mode runs indefinitely, so it can't keep every value
+    if (followMode) {
+        collected.streaming = true;
+    }
+    
+    if (grouped() && followMode) {
+        std::cerr << "Error: --by-column and --by-* cannot be combined with --follow" << std::endl;
+        exit(1);
+    }
+    if (refreshGiven && !followMode) {
+        std::cerr << "Error: --refresh-interval and --refresh-every need --follow" << std::endl;
+        exit(1);
+    }
+    if (!grouped() && (formatGiven || !outputFile.empty())) {
+        std::cerr << "Error: --output-format and --output need --by-column or a --by-* period" << std::endl;
+        exit(1);
+    }
+    
+    // "all" needs every column; otherwise just the one, the timestamp and
+    // the --by-column
+    if (!columnFilter.empty()) {
+        std::vector<std::string> columns = {columnFilter, Keys::Timestamp.str()};
+        if (!byColumn.empty()) columns.push_back(byColumn);
+        requireColumns(columns);
+    }
+}
+
+// ===== Summaries =====
+
+StatsAnalyser::TimeSummary StatsAnalyser::summarizeTimestamps(const std::vector<long long>& timestamps) {
+    TimeSummary summary{timestamps.size(), 0, 0, 0, 0, 0, 0, false};
+    if (timestamps.empty()) return summary;
+    
+    // Intervals are between neighbours in time order, so this one needs a
+    // real sort; readings usually arrive in order, and then it doesn't
+    std::vector<long long> sortedTs = timestamps;
+    if (!std::is_sorted(sortedTs.begin(), sortedTs.end())) {
+        ThreadPool::shared().sort(sortedTs.begin(), sortedTs.end());
+    }
+    summary.first = sortedTs.front();
+    summary.last = sortedTs.back();
+    
+    if (sortedTs.size() > 1) {
+        // Turn the copy into the intervals (sortedTs[0] is left as is)
+        std::adjacent_difference(sortedTs.begin(), sortedTs.end(), sortedTs.begin());
+        auto intervals = sortedTs.begin() + 1;
+        summary.intervalCount = sortedTs.size() - 1;
+        
+        // Typical interval: the upper median, selected rather than sorted for
+        auto median = intervals + summary.intervalCount / 2;
+        std::nth_element(intervals, median, sortedTs.end());
+        summary.medianInterval = *median;
+        
+        // Find gaps (more than 3x the median interval)
+        long long gapThreshold = summary.medianInterval * 3;
+        for (auto it = median + 1; it != sortedTs.end(); ++it) {
+            if (*it > gapThreshold) {
+                summary.gapCount++;
+                if (*it > summary.maxGap) summary.maxGap = *it;
+            }
+        }
+    }
+    return summary;
+}
+
+StatsAnalyser::TimeSummary StatsAnalyser::summarizeTimestamps(const TimestampStats& stats) {
+    const QuantileSketch& intervals = stats.intervals();
+    TimeSummary summary{static_cast<size_t>(stats.count()), stats.earliest(), stats.latest(),
+                        static_cast<size_t>(intervals.count()), 0, 0, 0, !intervals.exact()};
+    if (intervals.count() == 0) return summary;
+    
+    summary.medianInterval = static_cast<long long>(intervals.select(intervals.count() / 2));
+    long long gapThreshold = summary.medianInterval * 3;
+    summary.gapCount = static_cast<size_t>(intervals.countAbove(static_cast<double>(gapThreshold)));
+    if (stats.longestInterval() > gapThreshold) summary.maxGap = stats.longestInterval();
+    return summary;
+}
+
+StatsAnalyser::ColumnSummary StatsAnalyser::summarizeColumn(const std::vector<double>& values) {
+    ColumnSummary summary{};
+    summary.count = values.size();
+    
+    // Quartiles by selection on a scratch copy; values keeps its order for
+    // the deltas. The median goes first so the others partition a half each.
+    std::vector<double> scratch = values;
+    std::vector<double> quartiles = Percentiles::select(scratch, {50, 25, 75});
+    summary.median = quartiles[0];
+    summary.q1 = quartiles[1];
+    summary.q3 = quartiles[2];
+    double iqr = summary.q3 - summary.q1;
+    
+    // Everything else in two fused passes over the values in reading order;
+    // outliers by the 1.5 * IQR method, deltas between consecutive readings
+    SeriesMoments moments = SeriesKernels::compute(values.data(), values.size(),
+                                                   summary.q1 - 1.5 * iqr, summary.q3 + 1.5 * iqr);
+    summary.min = moments.min;
+    summary.max = moments.max;
+    summary.mean = moments.mean;
+    summary.stddev = moments.stddev;
+    summary.outlierCount = moments.outliers;
+    if (moments.deltaCount > 0) {
+        summary.deltaCount = moments.deltaCount;
+        summary.deltaMin = moments.deltaMin;
+        summary.deltaMax = moments.deltaMax;
+        summary.deltaMean = moments.deltaMean;
+        summary.volatility = moments.deltaStddev;  // std dev of deltas
+        summary.jumpFrom = values[moments.maxJumpIndex - 1];
+        summary.jumpTo = values[moments.maxJumpIndex];
+    }
+    return summary;
+}
+
+StatsAnalyser::ColumnSummary StatsAnalyser::summarizeColumn(const SeriesStats& stats) {
+    const RunningStats& values = stats.valueStats();
+    const RunningStats& deltas = stats.deltaStats();
+    const QuantileSketch& sketch = stats.quantiles();
+    
+    ColumnSummary summary{};
+    summary.count = static_cast<size_t>(values.count());
+    summary.min = values.min();
+    summary.max = values.max();
+    summary.mean = values.mean();
+    summary.stddev = values.stddev();
+    
+    summary.q1 = sketch.percentile(25);
+    summary.median = sketch.percentile(50);
+    summary.q3 = sketch.percentile(75);
+    double iqr = summary.q3 - summary.q1;
+    summary.outlierCount = static_cast<size_t>(sketch.countBelow(summary.q1 - 1.5 * iqr) +
+                                               sketch.countAbove(summary.q3 + 1.5 * iqr));
+    summary.estimated = !sketch.exact();
+    
+    summary.deltaCount = static_cast<size_t>(deltas.count());
+    summary.deltaMin = deltas.min();
+    summary.deltaMax = deltas.max();
+    summary.deltaMean = deltas.mean();
+    summary.volatility = deltas.stddev();
+    summary.jumpFrom = stats.maxJumpFrom();
+    summary.jumpTo = stats.maxJumpTo();
+    return summary;
 }
 
 // ===== Print stats helper =====
 
+void StatsAnalyser::printTimeSummary(const TimeSummary& summary) {
+    long long firstTs = summary.first;
+    long long lastTs = summary.last;
+    long long duration = lastTs - firstTs;
+    
+    // Format timestamps as human-readable dates
+    std::time_t firstTime = static_cast<std::time_t>(firstTs);
+    std::time_t lastTime = static_cast<std::time_t>(lastTs);
+    char firstBuf[64], lastBuf[64];
+    std::strftime(firstBuf, sizeof(firstBuf), "%Y-%m-%d %H:%M:%S", std::localtime(&firstTime));
+    std::strftime(lastBuf, sizeof(lastBuf), "%Y-%m-%d %H:%M:%S", std::localtime(&lastTime));
+    
+    std::cout << "Time Range:" << std::endl;
+    std::cout << "  First:     " << firstBuf << " (" << firstTs << ")" << std::endl;
+    std::cout << "  Last:      " << lastBuf << " (" << lastTs << ")" << std::endl;
+    
+    // Duration in human-readable format
+    long long days = duration / 86400;
+    long long hours = (duration % 86400) / 3600;
+    long long minutes = (duration % 3600) / 60;
+    long long seconds = duration % 60;
+    std::cout << "  Duration:  ";
+    if (days > 0) std::cout << days << "d ";
+    if (hours > 0 || days > 0) std::cout << hours << "h ";
+    if (minutes > 0 || hours > 0 || days > 0) std::cout << minutes << "m ";
+    std::cout << seconds << "s (" << duration << " seconds)" << std::endl;
+    
+    // Readings rate
+    if (duration > 0) {
+        double readingsPerHour = (double)summary.count / ((double)duration / 3600.0);
+        double readingsPerDay = (double)summary.count / ((double)duration / 86400.0);
+        std::cout << "  Rate:      " << std::fixed << std::setprecision(2) 
+                  << readingsPerHour << " readings/hour, "
+                  << readingsPerDay << " readings/day" << std::endl;
+        std::cout << std::defaultfloat;
+    }
+    
+    // Gap detection
+    if (summary.intervalCount > 0) {
+        long long maxGap = summary.maxGap;
+        std::cout << std::endl;
+        std::cout << (summary.estimated ? "  Sampling (estimated):" : "  Sampling:") << std::endl;
+        std::cout << "    Typical interval: " << summary.medianInterval << "s" << std::endl;
+        std::cout << "    Gaps detected:    " << summary.gapCount;
+        if (summary.gapCount > 0) {
+            std::cout << " (max gap: " << maxGap << "s = ";
+            long long gapHours = maxGap / 3600;
+            long long gapMins = (maxGap % 3600) / 60;
+            if (gapHours > 0) std::cout << gapHours << "h ";
+            std::cout << gapMins << "m)";
+        }
+        std::cout << std::endl;
+    }
+    
+    std::cout << std::endl;
+}
+
+void StatsAnalyser::printColumnSummary(const std::string& colName, const ColumnSummary& summary) {
+    double iqr = summary.q3 - summary.q1;
+    double outlierPercent = (summary.count > 0) ? (100.0 * summary.outlierCount / summary.count) : 0.0;
+    
+    std::cout << colName << ":" << std::endl;
+    std::cout << "  Count:    " << summary.count << std::endl;
+    std::cout << "  Min:      " << summary.min << std::endl;
+    std::cout << "  Max:      " << summary.max << std::endl;
+    std::cout << "  Range:    " << (summary.max - summary.min) << std::endl;
+    std::cout << "  Mean:     " << summary.mean << std::endl;
+    std::cout << "  StdDev:   " << summary.stddev << std::endl;
+    std::cout << std::endl;
+    std::cout << (summary.estimated ? "  Quartiles (estimated):" : "  Quartiles:") << std::endl;
+    std::cout << "    Q1 (25%):  " << summary.q1 << std::endl;
+    std::cout << "    Median:    " << summary.median << std::endl;
+    std::cout << "    Q3 (75%):  " << summary.q3 << std::endl;
+    std::cout << "    IQR:       " << iqr << std::endl;
+    std::cout << std::endl;
+    std::cout << (summary.estimated ? "  Outliers (1.5*IQR, estimated):" : "  Outliers (1.5*IQR):") << std::endl;
+    std::cout << "    Count:     " << summary.outlierCount << std::endl;
+    std::cout << "    Percent:   " << std::fixed << std::setprecision(1) << outlierPercent << "%" << std::endl;
+    std::cout << std::defaultfloat;
+    
+    if (summary.count > 1) {
+        std::cout << std::endl;
+        std::cout << "  Delta (consecutive changes):" << std::endl;
+        std::cout << "    Min:       " << std::fixed << std::setprecision(4) << summary.deltaMin << std::endl;
+        std::cout << "    Max:       " << summary.deltaMax << std::endl;
+        std::cout << "    Mean:      " << summary.deltaMean << std::endl;
+        std::cout << "    Volatility:" << summary.volatility << std::endl;
+        std::cout << std::endl;
+        std::cout << "  Max Jump:" << std::endl;
+        std::cout << "    Size:      " << summary.deltaMax << std::endl;
+        std::cout << "    From:      " << summary.jumpFrom << " -> " << summary.jumpTo << std::endl;
+        std::cout << std::defaultfloat;
+    }
+    
+    std::cout << std::endl;
+}
+
 void StatsAnalyser::printStats() {
-    if (columnData.empty()) {
+    if (collected.empty()) {
         std::cout << "No numeric data found" << std::endl;
         return;
     }
@@ -142,230 +485,290 @@ void StatsAnalyser::printStats() {
     std::cout << std::endl;
     
     // Time-based stats (if timestamps available)
-    if (!timestamps.empty()) {
-        std::vector<long long> sortedTs = timestamps;
-        std::sort(sortedTs.begin(), sortedTs.end());
-        
-        long long firstTs = sortedTs.front();
-        long long lastTs = sortedTs.back();
-        long long duration = lastTs - firstTs;
-        
-        // Format timestamps as human-readable dates
-        std::time_t firstTime = static_cast<std::time_t>(firstTs);
-        std::time_t lastTime = static_cast<std::time_t>(lastTs);
-        char firstBuf[64], lastBuf[64];
-        std::strftime(firstBuf, sizeof(firstBuf), "%Y-%m-%d %H:%M:%S", std::localtime(&firstTime));
-        std::strftime(lastBuf, sizeof(lastBuf), "%Y-%m-%d %H:%M:%S", std::localtime(&lastTime));
-        
-        std::cout << "Time Range:" << std::endl;
-        std::cout << "  First:     " << firstBuf << " (" << firstTs << ")" << std::endl;
-        std::cout << "  Last:      " << lastBuf << " (" << lastTs << ")" << std::endl;
-        
-        // Duration in human-readable format
-        long long days = duration / 86400;
-        long long hours = (duration % 86400) / 3600;
-        long long minutes = (duration % 3600) / 60;
-        long long seconds = duration % 60;
-        std::cout << "  Duration:  ";
-        if (days > 0) std::cout << days << "d ";
-        if (hours > 0 || days > 0) std::cout << hours << "h ";
-        if (minutes > 0 || hours > 0 || days > 0) std::cout << minutes << "m ";
-        std::cout << seconds << "s (" << duration << " seconds)" << std::endl;
-        
-        // Readings rate
-        if (duration > 0) {
-            double readingsPerHour = (double)timestamps.size() / ((double)duration / 3600.0);
-            double readingsPerDay = (double)timestamps.size() / ((double)duration / 86400.0);
-            std::cout << "  Rate:      " << std::fixed << std::setprecision(2) 
-                      << readingsPerHour << " readings/hour, "
-                      << readingsPerDay << " readings/day" << std::endl;
-            std::cout << std::defaultfloat;
+    if (collected.streaming) {
+        if (collected.timeStats.count() > 0) {
+            printTimeSummary(summarizeTimestamps(collected.timeStats));
         }
-        
-        // Gap detection
-        if (sortedTs.size() > 1) {
-            // Calculate typical interval
-            std::vector<long long> intervals;
-            for (size_t i = 1; i < sortedTs.size(); ++i) {
-                intervals.push_back(sortedTs[i] - sortedTs[i-1]);
-            }
-            std::sort(intervals.begin(), intervals.end());
-            long long medianInterval = intervals[intervals.size() / 2];
-            
-            // Find gaps (more than 3x the median interval)
-            long long gapThreshold = medianInterval * 3;
-            size_t gapCount = 0;
-            long long maxGap = 0;
-            for (long long interval : intervals) {
-                if (interval > gapThreshold) {
-                    gapCount++;
-                    if (interval > maxGap) maxGap = interval;
-                }
-            }
-            
-            std::cout << std::endl;
-            std::cout << "  Sampling:" << std::endl;
-            std::cout << "    Typical interval: " << medianInterval << "s" << std::endl;
-            std::cout << "    Gaps detected:    " << gapCount;
-            if (gapCount > 0) {
-                std::cout << " (max gap: " << maxGap << "s = ";
-                long long gapHours = maxGap / 3600;
-                long long gapMins = (maxGap % 3600) / 60;
-                if (gapHours > 0) std::cout << gapHours << "h ";
-                std::cout << gapMins << "m)";
-            }
-            std::cout << std::endl;
+        for (const auto& [colName, stats] : collected.columnStats) {
+            printColumnSummary(colName, summarizeColumn(stats));
         }
-        
-        std::cout << std::endl;
+        return;
     }
     
-    for (const auto& [colName, values] : columnData) {
+    if (!collected.timestamps.empty()) {
+        printTimeSummary(summarizeTimestamps(collected.timestamps));
+    }
+    for (const auto& [colName, values] : collected.columnData) {
         if (values.empty()) continue;
+        printColumnSummary(colName, summarizeColumn(values));
+    }
+}
+
+// ===== Grouped tables =====
+
+StatsAnalyser::GroupKey StatsAnalyser::groupOf(const Reading& reading) const {
+    GroupKey key{std::string(), 0, FieldKey()};
+    if (!byColumn.empty()) {
+        auto it = reading.find(byColumn);
+        key.value = (it != reading.end()) ? it->second : "(missing)";
+    }
+    if (byPeriod) {
+        key.period = DateUtils::periodKey(DateUtils::getTimestamp(reading), period);
+    }
+    return key;
+}
+
+void StatsAnalyser::collectGroupedFromReading(const Reading& reading, GroupTable& groups) const {
+    GroupKey key;
+    bool keyed = false;
+    for (const auto& [colName, colValue] : reading) {
+        // Skip if we're filtering by column and this isn't it
+        if (!columnFilter.empty() && colName != columnFilter) continue;
+        auto number = NumericUtils::parseDouble(colValue);
+        if (!number) continue;
         
-        // Sort values for percentile calculations
-        std::vector<double> sorted = values;
-        std::sort(sorted.begin(), sorted.end());
-        
-        double min = sorted.front();
-        double max = sorted.back();
-        double sum = 0.0;
-        for (double v : values) sum += v;
-        double mean = sum / values.size();
-        double stddev = calculateStdDev(values, mean);
-        
-        // Quartiles
-        double q1 = calculatePercentile(sorted, 25);
-        double median = calculatePercentile(sorted, 50);
-        double q3 = calculatePercentile(sorted, 75);
-        double iqr = q3 - q1;
-        
-        // Outliers (using 1.5 * IQR method)
-        double lowerFence = q1 - 1.5 * iqr;
-        double upperFence = q3 + 1.5 * iqr;
-        size_t outlierCount = 0;
-        for (double v : values) {
-            if (v < lowerFence || v > upperFence) {
-                outlierCount++;
-            }
+        if (!keyed) {
+            key = groupOf(reading);
+            keyed = true;
+        }
+        key.column = colName;
+        groups[key].add(*number);
+    }
+}
+
+void StatsAnalyser::mergeGroups(GroupTable& into, const GroupTable& from) {
+    for (const auto& [key, stats] : from) {
+        into[key].merge(stats);
+    }
+}
+
+namespace {
+
+// A grouped table value as text: CSV and JSON get more digits, and JSON
+// has no NaN or infinity
+std::string formatStat(double value, const std::string& format) {
+    if (format == "json" && !std::isfinite(value)) return "null";
+    std::ostringstream out;
+    if (format != "human") out << std::setprecision(10);
+    out << value;
+    return out.str();
+}
+
+std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+}  // namespace
+
+void StatsAnalyser::writeGroupedStats(const GroupTable& groups) const {
+    std::vector<const GroupTable::value_type*> cells;
+    cells.reserve(groups.size());
+    for (const auto& cell : groups) cells.push_back(&cell);
+    std::sort(cells.begin(), cells.end(), [](const auto* a, const auto* b) {
+        if (a->first.value != b->first.value) return a->first.value < b->first.value;
+        if (a->first.period != b->first.period) return a->first.period < b->first.period;
+        return a->first.column < b->first.column;
+    });
+    
+    // Set up output stream (file or stdout)
+    std::ofstream fileStream;
+    std::ostream* out = &std::cout;
+    if (!outputFile.empty()) {
+        fileStream.open(outputFile);
+        if (!fileStream) {
+            std::cerr << "Error: Cannot open output file '" << outputFile << "'" << std::endl;
+            return;
         }
-        double outlierPercent = (values.size() > 0) ? (100.0 * outlierCount / values.size()) : 0.0;
+        out = &fileStream;
+    }
+    
+    static const char* periodNames[] = {"hour", "day", "week", "month", "year"};
+    std::vector<std::string> header;
+    if (!byColumn.empty()) header.push_back(byColumn);
+    if (byPeriod) header.push_back(periodNames[static_cast<int>(period)]);
+    header.insert(header.end(), {"column", "count", "min", "max", "mean", "stddev", "q1", "median", "q3"});
+    
+    const bool json = outputFormat == "json";
+    bool anyEstimated = false;
+    std::vector<std::vector<std::string>> rows;
+    std::vector<bool> estimated;
+    for (const auto* cell : cells) {
+        const GroupKey& key = cell->first;
+        const RunningStats& values = cell->second.valueStats();
+        const QuantileSketch& sketch = cell->second.quantiles();
         
-        // Delta stats (differences between consecutive readings)
-        double deltaMin = 0, deltaMax = 0, deltaSum = 0;
-        std::vector<double> deltas;
-        size_t deltaCount = 0;
-        size_t maxJumpIndex = 1;  // Start at 1 (first valid index for a jump)
-        if (values.size() > 1) {
-            deltaMin = std::abs(values[1] - values[0]);
-            deltaMax = deltaMin;
-            for (size_t i = 1; i < values.size(); ++i) {
-                double delta = std::abs(values[i] - values[i-1]);
-                deltas.push_back(delta);
-                deltaSum += delta;
-                if (delta < deltaMin) deltaMin = delta;
-                if (delta > deltaMax) {
-                    deltaMax = delta;
-                    maxJumpIndex = i;
+        std::vector<std::string> row;
+        if (!byColumn.empty()) row.push_back(key.value);
+        if (byPeriod) row.push_back(DateUtils::periodLabel(key.period, period));
+        row.push_back(key.column.str());
+        row.push_back(std::to_string(values.count()));
+        for (double stat : {values.min(), values.max(), values.mean(), values.stddev(),
+                            sketch.percentile(25), sketch.percentile(50), sketch.percentile(75)}) {
+            row.push_back(formatStat(stat, outputFormat));
+        }
+        rows.push_back(std::move(row));
+        estimated.push_back(!sketch.exact());
+        anyEstimated = anyEstimated || !sketch.exact();
+    }
+    
+    // Leading columns are labels; the rest are numbers
+    const size_t labelColumns = header.size() - 8;
+    
+    if (json) {
+        *out << "[";
+        for (size_t r = 0; r < rows.size(); ++r) {
+            if (r > 0) *out << ",";
+            *out << "{";
+            for (size_t c = 0; c < header.size(); ++c) {
+                if (c > 0) *out << ",";
+                *out << "\"" << escapeJsonString(header[c]) << "\":";
+                if (c < labelColumns) {
+                    *out << "\"" << escapeJsonString(rows[r][c]) << "\"";
+                } else {
+                    *out << rows[r][c];
                 }
             }
-            deltaCount = values.size() - 1;
+            *out << ",\"estimated\":" << (estimated[r] ? "true" : "false") << "}";
         }
-        double deltaMean = (deltaCount > 0) ? (deltaSum / deltaCount) : 0.0;
-        
-        // Volatility (std dev of deltas)
-        double volatility = 0.0;
-        if (deltas.size() > 1) {
-            double deltaVarianceSum = 0.0;
-            for (double d : deltas) {
-                deltaVarianceSum += (d - deltaMean) * (d - deltaMean);
+        *out << "]\n";
+    } else if (outputFormat == "csv") {
+        for (size_t c = 0; c < header.size(); ++c) {
+            *out << (c > 0 ? "," : "") << csvField(header[c]);
+        }
+        *out << ",estimated\n";
+        for (size_t r = 0; r < rows.size(); ++r) {
+            for (size_t c = 0; c < header.size(); ++c) {
+                *out << (c > 0 ? "," : "") << csvField(rows[r][c]);
             }
-            volatility = std::sqrt(deltaVarianceSum / (deltas.size() - 1));
+            *out << "," << (estimated[r] ? "true" : "false") << "\n";
         }
-        
-        std::cout << colName << ":" << std::endl;
-        std::cout << "  Count:    " << values.size() << std::endl;
-        std::cout << "  Min:      " << min << std::endl;
-        std::cout << "  Max:      " << max << std::endl;
-        std::cout << "  Range:    " << (max - min) << std::endl;
-        std::cout << "  Mean:     " << mean << std::endl;
-        std::cout << "  StdDev:   " << stddev << std::endl;
-        std::cout << std::endl;
-        std::cout << "  Quartiles:" << std::endl;
-        std::cout << "    Q1 (25%):  " << q1 << std::endl;
-        std::cout << "    Median:    " << median << std::endl;
-        std::cout << "    Q3 (75%):  " << q3 << std::endl;
-        std::cout << "    IQR:       " << iqr << std::endl;
-        std::cout << std::endl;
-        std::cout << "  Outliers (1.5*IQR):" << std::endl;
-        std::cout << "    Count:     " << outlierCount << std::endl;
-        std::cout << "    Percent:   " << std::fixed << std::setprecision(1) << outlierPercent << "%" << std::endl;
-        std::cout << std::defaultfloat;
-        
-        if (values.size() > 1) {
-            std::cout << std::endl;
-            std::cout << "  Delta (consecutive changes):" << std::endl;
-            std::cout << "    Min:       " << std::fixed << std::setprecision(4) << deltaMin << std::endl;
-            std::cout << "    Max:       " << deltaMax << std::endl;
-            std::cout << "    Mean:      " << deltaMean << std::endl;
-            std::cout << "    Volatility:" << volatility << std::endl;
-            std::cout << std::endl;
-            std::cout << "  Max Jump:" << std::endl;
-            std::cout << "    Size:      " << deltaMax << std::endl;
-            std::cout << "    From:      " << values[maxJumpIndex - 1] << " -> " << values[maxJumpIndex] << std::endl;
-            std::cout << std::defaultfloat;
+    } else {
+        if (rows.empty()) {
+            *out << "No numeric data found" << std::endl;
+        } else {
+            std::vector<size_t> widths;
+            for (const auto& label : header) widths.push_back(label.size());
+            for (const auto& row : rows) {
+                for (size_t c = 0; c < row.size(); ++c) widths[c] = std::max(widths[c], row[c].size());
+            }
+            // Columns are padded to line up; the last only when a "*" follows
+            size_t last = header.size() - 1;
+            size_t lineWidth = widths[last];
+            for (size_t c = 0; c < last; ++c) {
+                *out << std::left << std::setw(static_cast<int>(widths[c] + 2)) << header[c];
+                lineWidth += widths[c] + 2;
+            }
+            *out << header[last] << "\n" << std::string(lineWidth, '-') << "\n";
+            for (size_t r = 0; r < rows.size(); ++r) {
+                for (size_t c = 0; c < last; ++c) {
+                    *out << std::left << std::setw(static_cast<int>(widths[c] + 2)) << rows[r][c];
+                }
+                if (estimated[r]) {
+                    *out << std::setw(static_cast<int>(widths[last] + 2)) << rows[r][last] << "*\n";
+                } else {
+                    *out << rows[r][last] << "\n";
+                }
+            }
+            *out << std::right;
+            if (anyEstimated) {
+                *out << "\n* q1, median and q3 estimated (within about 1% in rank)\n";
+            }
         }
-        
-        std::cout << std::endl;
+    }
+    
+    if (!outputFile.empty()) {
+        fileStream.close();
+        std::cerr << "Output written to: " << outputFile << std::endl;
     }
 }
 
-// ===== Follow mode for stdin =====
+// ===== Follow mode =====
 
-void StatsAnalyser::analyzeStdinFollow() {
-    // Print initial stats (will say "No numeric data found")
+void StatsAnalyser::refreshStats() {
     printStats();
     std::cout << "---" << std::endl;
+    unprintedReadings = 0;
+    lastRefresh = std::chrono::steady_clock::now();
+}
+
+void StatsAnalyser::followReading(const Reading& reading) {
+    collectDataFromReading(reading);
+    if (++unprintedReadings < refreshEvery) return;
+    if (refreshInterval > 0) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - lastRefresh;
+        if (elapsed.count() < refreshInterval) return;
+    }
+    refreshStats();
+}
+
+void StatsAnalyser::followIdle() {
+    if (unprintedReadings > 0) refreshStats();
+}
+
+void StatsAnalyser::analyzeStdinFollow() {
+    // Print initial stats (will say "No numeric data found")
+    refreshStats();
     
     // Use DataReader for parsing and filtering - only filtered readings reach callback
     auto reader = createDataReader();
     reader.processStdinFollow([&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
-        collectDataFromReading(reading);
-        printStats();
-        std::cout << "---" << std::endl;
-    });
+        followReading(reading);
+    }, [&] { followIdle(); });
 }
 
 void StatsAnalyser::analyzeFileFollow(const std::string& filename) {
     // Use DataReader for parsing and filtering - only filtered readings reach callback
     auto reader = createDataReader();
     
-    // First process existing content to build initial stats
-    reader.processFile(filename, [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
-        collectDataFromReading(reading);
-    });
-    
-    // Print initial stats
-    printStats();
-    std::cout << "---" << std::endl;
-    
-    // Now follow for new content
+    // The existing content builds the initial stats, printed once the
+    // reader has caught up with the end of the file; after that, follow
+    bool caughtUp = false;
     reader.processFileFollow(filename, [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
-        collectDataFromReading(reading);
-        printStats();
-        std::cout << "---" << std::endl;
+        if (caughtUp) {
+            followReading(reading);
+        } else {
+            collectDataFromReading(reading);
+        }
+    }, [&] {
+        if (caughtUp) {
+            followIdle();
+        } else {
+            caughtUp = true;
+            refreshStats();
+        }
     });
 }
 
-// Helper struct for parallel processing
-struct LocalStatsData {
-    std::map<std::string, std::vector<double>> columnData;
-    std::vector<long long> timestamps;
-};
-
 // ===== Main analyze method =====
 
 void StatsAnalyser::analyze() {
+    // Helper struct for parallel processing
+    struct LocalStatsData {
+        CollectedData data;
+        GroupTable groups;  // --by-column, --by-*
+        
+        // --unique: a file's first copy of each row waits here until the
+        // ordered merge has decided whether it is the first overall
+        struct PendingRow {
+            ReadingFilter::UniqueKey key;
+            size_t valuesEnd;  // end of this row's entries in values
+            bool hasTimestamp;
+            long long timestamp;
+        };
+        std::vector<PendingRow> rows;
+        std::vector<GroupKey> rowGroups;  // one per row, only when grouped
+        std::vector<std::pair<FieldKey, double>> values;
+    };
+    LocalStatsData initial;
+    initial.data.streaming = collected.streaming;
+    GroupTable groups;
+    
     if (inputFiles.empty() && followMode) {
         // Follow mode with stdin
         analyzeStdinFollow();
@@ -388,78 +791,132 @@ void StatsAnalyser::analyze() {
         DataReader reader = createDataReader();
         auto collectData = [&](const Reading& reading, int /*lineNum*/, const std::string& /*source*/) {
             // Filtering already done by DataReader
-            collectDataFromReading(reading);
+            if (grouped()) {
+                collectGroupedFromReading(reading, groups);
+            } else {
+                collectDataFromReading(reading);
+            }
         };
         reader.processStdin(collectData);
-    } else if (uniqueRows) {
-        // When --unique is enabled, use parallel processing with a shared filter
-        // The shared filter's seenRows set is mutex-protected for thread safety
+    } else if (uniqueRows && !readsSequentially(inputFiles.size(), jobs) &&
+               uniqueMemoryMB == 0 && !collected.streaming) {
+        // When --unique is enabled and files are read in parallel, workers
+        // drop repeats within their file and the ordered merge claims each
+        // remaining row's key in file order, so the first occurrence wins as
+        // in a sequential run (deltas and volatility depend on it)
         printCommonVerboseInfo("Analyzing", verbosity, recursive, extensionFilter, maxDepth, inputFiles.size());
         
         ReadingFilter sharedFilter = createFilter();
+        const bool hasUpdates = !updateRules.empty();
         
-        auto processFileWithSharedFilter = [this, &sharedFilter](const std::string& file) -> LocalStatsData {
-            LocalStatsData local;
-            DataReader reader = createDataReaderWithSharedFilter(sharedFilter);
+        auto processFileDeferred = [this, &sharedFilter, hasUpdates, &initial](const std::string& file) -> LocalStatsData {
+            LocalStatsData local = initial;
+            DataReader reader = createDeferredUniqueReader();
+            SeenRowSet seenInFile;  // a later copy in this file is never the first
+            Reading updated;
             
             reader.processFile(file, [&](const Reading& reading, int, const std::string&) {
-                // Filtering already done by DataReader
+                LocalStatsData::PendingRow pending;
+                pending.key = sharedFilter.uniqueKey(reading);
+                bool newInFile = uniqueExact ? seenInFile.insert(pending.key.fingerprint, pending.key.row)
+                                             : seenInFile.insert(pending.key.fingerprint);
+                if (!newInFile) {
+                    if (verbosity >= 2) {
+                        std::cerr << "  Skipping row: duplicate" << std::endl;
+                    }
+                    return;
+                }
                 
-                // Collect timestamp if present
-                auto tsIt = reading.find("timestamp");
-                if (tsIt != reading.end() && isNumeric(tsIt->second)) {
-                    long long ts = std::stoll(tsIt->second);
-                    local.timestamps.push_back(ts);
+                const Reading* row = &reading;
+                if (hasUpdates) {
+                    updated = reading;
+                    sharedFilter.applyTransformations(updated);
+                    row = &updated;
                 }
                 
-                for (const auto& [colName, colValue] : reading) {
+                // Collect timestamp if present
+                auto tsIt = row->find(Keys::Timestamp);
+                auto ts = tsIt != row->end() ? NumericUtils::parseInteger(tsIt->second) : std::nullopt;
+                pending.hasTimestamp = ts.has_value();
+                pending.timestamp = ts.value_or(0);
+                if (grouped()) local.rowGroups.push_back(groupOf(*row));
+                
+                for (const auto& [colName, colValue] : *row) {
                     // Skip if we're filtering by column and this isn't it
                     if (!columnFilter.empty() && colName != columnFilter) continue;
                     
                     // Try to parse as numeric
-                    if (isNumeric(colValue)) {
-                        double value = std::stod(colValue);
-                        local.columnData[colName].push_back(value);
+                    if (auto number = NumericUtils::parseDouble(colValue)) {
+                        local.values.emplace_back(colName, *number);
                     }
                 }
+                pending.valuesEnd = local.values.size();
+                local.rows.push_back(std::move(pending));
             });
             
             return local;
         };
         
-        // Combine function: merge column data and timestamps
-        auto combineStats = [](LocalStatsData& combined, const LocalStatsData& local) {
-            // Merge column data
-            for (const auto& [colName, colValues] : local.columnData) {
-                auto& target = combined.columnData[colName];
-                target.insert(target.end(), colValues.begin(), colValues.end());
+        // Combine function: keep the rows whose key is claimed first. They
+        // are collected per file and appended, as on the other paths, so
+        // streaming accumulators see the same order whatever -j is
+        auto combineStats = [this, &sharedFilter, &initial](LocalStatsData& combined, LocalStatsData& local) {
+            LocalStatsData file = initial;
+            size_t start = 0;
+            for (size_t r = 0; r < local.rows.size(); ++r) {
+                auto& row = local.rows[r];
+                bool firstCopy = sharedFilter.claimUniqueKey(std::move(row.key));
+                if (firstCopy && grouped()) {
+                    GroupKey& group = local.rowGroups[r];
+                    for (size_t i = start; i < row.valuesEnd; ++i) {
+                        group.column = local.values[i].first;
+                        file.groups[group].add(local.values[i].second);
+                    }
+                } else if (firstCopy) {
+                    if (row.hasTimestamp) {
+                        file.data.addTimestamp(row.timestamp);
+                    }
+                    for (size_t i = start; i < row.valuesEnd; ++i) {
+                        file.data.addValue(local.values[i].first, local.values[i].second);
+                    }
+                }
+                start = row.valuesEnd;
             }
-            // Merge timestamps
-            combined.timestamps.insert(combined.timestamps.end(), 
-                                       local.timestamps.begin(), local.timestamps.end());
+            combined.data.append(file.data);
+            mergeGroups(combined.groups, file.groups);
         };
         
-        LocalStatsData result = processFilesParallel(inputFiles, processFileWithSharedFilter, combineStats, LocalStatsData());
-        
-        // Copy results to member variables
-        columnData = std::move(result.columnData);
-        timestamps = std::move(result.timestamps);
+        LocalStatsData result = processFilesParallel(inputFiles, processFileDeferred, combineStats, initial, jobs);
+        collected = std::move(result.data);
+        groups = std::move(result.groups);
     } else {
         printCommonVerboseInfo("Analyzing", verbosity, recursive, extensionFilter, maxDepth, inputFiles.size());
         
+        // Files read one after another can claim --unique keys on a shared
+        // filter as they go: the first occurrence is then the first read.
+        // --unique-memory and --streaming promise bounded memory, which
+        // deferring whole files for the ordered merge would break, so they
+        // read files in order and split each one across threads instead
+        ReadingFilter sharedFilter = createFilter();
+        const int fileJobs = uniqueRows ? 1 : jobs;
+        
         // Process files in parallel
-        auto processFile = [this](const std::string& file) -> LocalStatsData {
-            LocalStatsData local;
-            DataReader reader = createDataReader();
+        auto processFile = [this, &initial, &sharedFilter](const std::string& file) -> LocalStatsData {
+            LocalStatsData local = initial;
+            DataReader reader = uniqueRows ? createDataReaderWithSharedFilter(sharedFilter) : createDataReader();
+            if (uniqueRows) reader.setChunkThreads(static_cast<size_t>(jobs));
             
             reader.processFile(file, [&](const Reading& reading, int, const std::string&) {
                 // Filtering already done by DataReader
+                if (grouped()) {
+                    collectGroupedFromReading(reading, local.groups);
+                    return;
+                }
                 
                 // Collect timestamp if present
-                auto tsIt = reading.find("timestamp");
-                if (tsIt != reading.end() && isNumeric(tsIt->second)) {
-                    long long ts = std::stoll(tsIt->second);
-                    local.timestamps.push_back(ts);
+                auto tsIt = reading.find(Keys::Timestamp);
+                if (tsIt != reading.end()) {
+                    if (auto ts = NumericUtils::parseInteger(tsIt->second)) local.data.addTimestamp(*ts);
                 }
                 
                 for (const auto& [colName, colValue] : reading) {
@@ -467,9 +924,8 @@ void StatsAnalyser::analyze() {
                     if (!columnFilter.empty() && colName != columnFilter) continue;
                     
                     // Try to parse as numeric
-                    if (isNumeric(colValue)) {
-                        double value = std::stod(colValue);
-                        local.columnData[colName].push_back(value);
+                    if (auto number = NumericUtils::parseDouble(colValue)) {
+                        local.data.addValue(colName, *number);
                     }
                 }
             });
@@ -477,26 +933,22 @@ void StatsAnalyser::analyze() {
             return local;
         };
         
-        // Combine function: merge column data and timestamps
-        auto combineStats = [](LocalStatsData& combined, const LocalStatsData& local) {
-            // Merge column data
-            for (const auto& [colName, colValues] : local.columnData) {
-                auto& target = combined.columnData[colName];
-                target.insert(target.end(), colValues.begin(), colValues.end());
-            }
-            // Merge timestamps
-            combined.timestamps.insert(combined.timestamps.end(), 
-                                       local.timestamps.begin(), local.timestamps.end());
+        // Combine function: append each file's data after the files before it
+        auto combineStats = [](LocalStatsData& combined, LocalStatsData& local) {
+            combined.data.append(local.data);
+            mergeGroups(combined.groups, local.groups);
         };
         
-        LocalStatsData result = processFilesParallel(inputFiles, processFile, combineStats, LocalStatsData());
-        
-        // Copy results to member variables
-        columnData = std::move(result.columnData);
-        timestamps = std::move(result.timestamps);
+        LocalStatsData result = processFilesParallel(inputFiles, processFile, combineStats, initial, fileJobs);
+        collected = std::move(result.data);
+        groups = std::move(result.groups);
     }
     
-    printStats();
+    if (grouped()) {
+        writeGroupedStats(groups);
+    } else {
+        printStats();
+    }
 }
 
 // ===== Usage printing =====
@@ -512,6 +964,16 @@ void StatsAnalyser::printStatsUsage(const char* progName) {
     std::cerr << "  -c, --column <name>       Analyze only this column (default: value, use 'all' for all columns)" << std::endl;
     std::cerr << "  -if, --input-format <fmt> Input format for stdin: json or csv (default: json)" << std::endl;
     std::cerr << "  -f, --follow              Follow mode: continuously read input and update stats (stdin or single file)" << std::endl;
+    std::cerr << "  --refresh-interval <sec>  With --follow, print the stats at most once every sec seconds" << std::endl;
+    std::cerr << "  --refresh-every <n>       With --follow, print the stats after every n new readings (default: 1)" << std::endl;
+    std::cerr << "                            (either way they are printed whenever the input runs dry)" << std::endl;
+    std::cerr << "  -b, --by-column <col>     One table row per value of this column (count, min, max, mean, stddev, quartiles)" << std::endl;
+    std::cerr << "  --by-hour, --by-day, --by-week, --by-month, --by-year" << std::endl;
+    std::cerr << "                            One table row per UTC period (combines with --by-column)" << std::endl;
+    std::cerr << "  -of, --output-format <fmt> Table format: human (default), csv, or json" << std::endl;
+    std::cerr << "  -o, --output <file>       Write the table to a file instead of stdout" << std::endl;
+    std::cerr << "  --streaming               Use constant memory: quartiles, outliers and typical interval are estimated" << std::endl;
+    std::cerr << "                            (within about 1% in rank) once a column has 200 or more values; always on with --follow" << std::endl;
     std::cerr << "  --only-value <col:val>    Only include rows where column has specific value (can be used multiple times)" << std::endl;
     std::cerr << "  --exclude-value <col:val> Exclude rows where column has specific value (can be used multiple times)" << std::endl;
     std::cerr << "  --allowed-values <col> <values|file>  Only include rows where column is in allowed values" << std::endl;
@@ -520,11 +982,15 @@ void StatsAnalyser::printStatsUsage(const char* progName) {
     std::cerr << "  --remove-errors           Remove error readings (DS18B20 value=85 or -127)" << std::endl;
     std::cerr << "  --clean                   Shorthand for --remove-empty-json --not-empty value --remove-errors --not-null value --not-null sensor_id --unique" << std::endl;
     std::cerr << "  --unique                  Only output unique rows (removes duplicates)" << std::endl;
+    std::cerr << "  --unique-exact            Like --unique, but compare whole rows instead of 128-bit hashes" << std::endl;
+    std::cerr << "  --unique-memory <MB>      Like --unique, but keep seen rows within MB of memory, spilling to disk beyond it" << std::endl;
     std::cerr << "  -r, --recursive           Recursively process subdirectories" << std::endl;
     std::cerr << "  -v                        Verbose output" << std::endl;
     std::cerr << "  -V                        Very verbose output" << std::endl;
     std::cerr << "  -e, --extension <ext>     Filter files by extension (e.g., .out or out)" << std::endl;
     std::cerr << "  -d, --depth <n>           Maximum recursion depth (0 = current dir only)" << std::endl;
+    std::cerr << "  -j, --jobs <n>            Worker threads (default: number of CPU cores)" << std::endl;
+    std::cerr << "  --io-jobs <n>             Maximum files read at once (default: no limit)" << std::endl;
     std::cerr << "  --min-date <date>         Filter readings after this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << "  --max-date <date>         Filter readings before this date (Unix timestamp, ISO date, or DD/MM/YYYY)" << std::endl;
     std::cerr << "  --tail <n>                Only read the last n lines from each file" << std::endl;
@@ -541,5 +1007,8 @@ void StatsAnalyser::printStatsUsage(const char* progName) {
     std::cerr << "  " << progName << " stats sensor1.csv sensor2.out" << std::endl;
     std::cerr << "  " << progName << " stats --only-value sensor:ds18b20 sensor.out" << std::endl;
     std::cerr << "  tail -f sensor.out | " << progName << " stats --follow" << std::endl;
+    std::cerr << "  " << progName << " stats --follow --refresh-interval 60 sensor.out" << std::endl;
+    std::cerr << "  " << progName << " stats --by-column sensor_id --by-day -of csv -r /path/to/logs/" << std::endl;
+    std::cerr << "  " << progName << " stats --streaming -r /path/to/logs/  # years of logs in little memory" << std::endl;
     std::cerr << "  " << progName << " stats --clean sensor.out  # exclude empty values" << std::endl;
 }
@@ -39,6 +39,7 @@ public:
     using CommandBase::shouldIncludeReading;
     using CommandBase::passesDateFilter;
     using CommandBase::areAllReadingsEmpty;
+    using CommandBase::processFilesParallel;
     
     // Expose protected members for testing
     using CommandBase::minDate;
@@ -341,6 +342,26 @@ bool test_multiple_filters_one_fails() {
     ASSERT_FALSE(cmd.shouldIncludeReading(reading));
 }
 
+// ==================== processFilesParallel tests ====================
+
+bool test_parallel_combines_in_file_order() {
+    // Nonexistent files all have unknown size, so they are scheduled in list order,
+    // but results must be combined in list order however the tasks finish
+    std::vector<std::string> files;
+    for (int i = 0; i < 40; ++i) {
+        files.push_back("missing_file_" + std::to_string(i));
+    }
+    auto result = TestableCommand::processFilesParallel<std::vector<std::string>>(
+        files,
+        [](const std::string& file) { return std::vector<std::string>{file}; },
+        [](std::vector<std::string>& acc, const std::vector<std::string>& part) {
+            acc.insert(acc.end(), part.begin(), part.end());
+        },
+        std::vector<std::string>(),
+        4);
+    ASSERT_TRUE(result == files);
+}
+
 // ==================== Main ====================
 
 int main() {
@@ -380,6 +401,9 @@ int main() {
     std::cout << (test_multiple_filters_all_pass() ? "[PASS]" : "[FAIL]") << " test_multiple_filters_all_pass" << std::endl;
     std::cout << (test_multiple_filters_one_fails() ? "[PASS]" : "[FAIL]") << " test_multiple_filters_one_fails" << std::endl;
     
+    // processFilesParallel tests
+    std::cout << (test_parallel_combines_in_file_order() ? "[PASS]" : "[FAIL]") << " test_parallel_combines_in_file_order" << std::endl;
+    
     std::cout << "\n" << tests_passed << "/" << tests_run << " tests passed" << std::endl;
     
     return tests_passed == tests_run ? 0 : 1;
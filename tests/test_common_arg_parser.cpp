@@ -188,6 +188,80 @@ void test_tail_lines() {
     std::cout << "[PASS] test_tail_lines" << std::endl;
 }
 
+void test_jobs() {
+    CommonArgParser parser;
+    std::vector<std::string> args = {"program", "-j", "3", "--io-jobs", "1", "data.out"};
+    auto argv = make_argv(args);
+    
+    bool result = parser.parse(static_cast<int>(argv.size()), argv.data());
+    assert(result == true);
+    assert(parser.getJobs() == 3);
+    assert(parser.getIoJobs() == 1);
+    assert(CommonArgParser::checkUnknownOptions(static_cast<int>(argv.size()), argv.data()).empty());
+    
+    std::cout << "[PASS] test_jobs" << std::endl;
+}
+
+void test_jobs_defaults_and_invalid() {
+    CommonArgParser defaults;
+    assert(defaults.getJobs() == CommonArgParser::defaultJobs());
+    assert(defaults.getJobs() >= 1);
+    assert(defaults.getIoJobs() == 0);
+    
+    CommonArgParser parser;
+    std::vector<std::string> args = {"program", "--jobs", "0"};
+    auto argv = make_argv(args);
+    bool result = parser.parse(static_cast<int>(argv.size()), argv.data());
+    assert(result == false);
+    
+    std::cout << "[PASS] test_jobs_defaults_and_invalid" << std::endl;
+}
+
+void test_unique_exact() {
+    CommonArgParser parser;
+    std::vector<std::string> args = {"program", "--unique-exact"};
+    auto argv = make_argv(args);
+    bool result = parser.parse(static_cast<int>(argv.size()), argv.data());
+    assert(result == true);
+    assert(parser.getUniqueRows());
+    assert(parser.getUniqueExact());
+    
+    CommonArgParser plain;
+    std::vector<std::string> plainArgs = {"program", "--unique"};
+    auto plainArgv = make_argv(plainArgs);
+    result = plain.parse(static_cast<int>(plainArgv.size()), plainArgv.data());
+    assert(result == true);
+    assert(plain.getUniqueRows());
+    assert(!plain.getUniqueExact());
+    
+    std::cout << "[PASS] test_unique_exact" << std::endl;
+}
+
+void test_unique_memory() {
+    CommonArgParser parser;
+    std::vector<std::string> args = {"program", "--unique-memory", "256"};
+    auto argv = make_argv(args);
+    bool result = parser.parse(static_cast<int>(argv.size()), argv.data());
+    assert(result == true);
+    assert(parser.getUniqueRows());
+    assert(parser.getUniqueMemoryMB() == 256);
+    
+    CommonArgParser zero;
+    std::vector<std::string> zeroArgs = {"program", "--unique-memory", "0"};
+    auto zeroArgv = make_argv(zeroArgs);
+    result = zero.parse(static_cast<int>(zeroArgv.size()), zeroArgv.data());
+    assert(result == false);
+    
+    // Exact rows can't be spilled as fingerprints
+    CommonArgParser exact;
+    std::vector<std::string> exactArgs = {"program", "--unique-exact", "--unique-memory", "64"};
+    auto exactArgv = make_argv(exactArgs);
+    result = exact.parse(static_cast<int>(exactArgv.size()), exactArgv.data());
+    assert(result == false);
+    
+    std::cout << "[PASS] test_unique_memory" << std::endl;
+}
+
 void test_min_date_unix() {
     CommonArgParser parser;
     std::vector<std::string> args = {"program", "--min-date", "1700000000"};
@@ -387,6 +461,12 @@ int main() {
     // Tail
     test_tail_lines();
     
+    // Parallelism
+    test_jobs();
+    test_jobs_defaults_and_invalid();
+    test_unique_exact();
+    test_unique_memory();
+    
     // Date filtering
     test_min_date_unix();
     test_max_date_unix();
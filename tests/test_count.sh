@@ -1039,6 +1039,24 @@ else
     FAILED=$((FAILED + 1))
 fi
 
+# Test: --by-column together with --by-day still reads the timestamps
+echo ""
+echo "Test: -b with --by-day counts per day"
+input='{"sensor_id": "a", "timestamp": "2024-01-01T10:00:00"}
+{"sensor_id": "a", "timestamp": "2024-01-02T10:00:00"}
+{"sensor_id": "b", "timestamp": "2024-01-02T11:00:00"}'
+result=$(echo "$input" | ./sensor-data count -b sensor_id --by-day -of csv)
+if echo "$result" | grep -q "^2024-01-01,1$" && echo "$result" | grep -q "^2024-01-02,2$" && \
+   ! echo "$result" | grep -q "no-date"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL"
+    echo "  Expected one row per day"
+    echo "  Got: $result"
+    FAILED=$((FAILED + 1))
+fi
+
 # Test: --by-year basic functionality
 echo ""
 echo "Test: --by-year counts by year (YYYY)"
@@ -138,6 +138,47 @@ void test_csv_many_fields() {
     std::cout << "[PASS] test_csv_many_fields" << std::endl;
 }
 
+void test_csv_header_interned() {
+    std::istringstream input("");
+    std::string line = "sensor_id,\"site name\",value";
+    bool needMore = false;
+    auto headers = CsvParser::parseCsvHeader(input, line, needMore);
+    assert(headers.size() == 3);
+    assert(headers[0] == Keys::SensorId);
+    assert(headers[1] == "site name");
+    assert(headers[2] == Keys::Value);
+    std::cout << "[PASS] test_csv_header_interned" << std::endl;
+}
+
+void test_csv_record_from_buffer() {
+    std::string data = "a,\"multi\nline\",c\r\nd,e,f";
+    size_t pos = 0;
+    auto first = CsvParser::parseCsvRecord(data, pos);
+    assert(first.size() == 3);
+    assert(first[1] == "multi\nline");
+    assert(first[2] == "c");
+    auto second = CsvParser::parseCsvRecord(data, pos);
+    assert(second.size() == 3);
+    assert(second[0] == "d");
+    assert(second[2] == "f");
+    assert(pos == data.size());
+    std::cout << "[PASS] test_csv_record_from_buffer" << std::endl;
+}
+
+void test_csv_record_keep_mask() {
+    std::string data = "a,\"skip\nme\",c,d\nnext\n";
+    std::vector<bool> keep = {true, false, true};  // past the end: skipped
+    size_t pos = 0;
+    auto fields = CsvParser::parseCsvRecord(data, pos, &keep);
+    assert(fields.size() == 4);
+    assert(fields[0] == "a");
+    assert(fields[1].empty());
+    assert(fields[2] == "c");
+    assert(fields[3].empty());
+    assert(data.substr(pos) == "next\n");
+    std::cout << "[PASS] test_csv_record_keep_mask" << std::endl;
+}
+
 int main() {
     std::cout << "Running CSV Parser Tests..." << std::endl;
     test_simple_csv();
@@ -154,6 +195,9 @@ int main() {
     test_csv_quoted_empty();
     test_csv_unicode_content();
     test_csv_many_fields();
+    test_csv_header_interned();
+    test_csv_record_from_buffer();
+    test_csv_record_keep_mask();
     std::cout << "All CSV Parser tests passed!" << std::endl;
     return 0;
 }
@@ -419,6 +419,26 @@ void test_unique_rows_filter() {
     std::cout << "[PASS] test_unique_rows_filter" << std::endl;
 }
 
+void test_unique_exact_rows_filter() {
+    TempFile file(
+        "{\"sensor_id\":\"s1\",\"value\":\"22.5\"}\n"
+        "{\"value\":\"22.5\",\"sensor_id\":\"s1\"}\n"  // same row, other field order
+        "{\"sensor_id\":\"s1\",\"value\":\"22.5\",\"unit\":\"\"}\n"
+    );
+    
+    DataReader reader(0, "json");
+    reader.getFilter().setUniqueRows(true);
+    reader.getFilter().setExactUnique(true);
+    
+    int count = 0;
+    reader.processFile(file.path, [&](const Reading&, int, const std::string&) {
+        count++;
+    });
+    
+    assert(count == 2);
+    std::cout << "[PASS] test_unique_exact_rows_filter" << std::endl;
+}
+
 void test_combined_filters() {
     TempFile file(
         "{\"sensor_id\":\"s1\",\"timestamp\":\"500\",\"status\":\"active\",\"value\":\"22.5\"}\n"
@@ -439,6 +459,34 @@ void test_combined_filters() {
     std::cout << "[PASS] test_combined_filters" << std::endl;
 }
 
+void test_filter_setters_replace_checks() {
+    ReadingFilter filter;
+    Reading active{{"sensor_id", "s1"}, {"status", "active"}, {"timestamp", "500"}};
+    Reading nullId{{"sensor_id", "null"}, {"status", "active"}, {"timestamp", "500"}};
+    Reading old{{"sensor_id", "s2"}, {"status", "idle"}, {"timestamp", "100"}};
+    assert(filter.matches(active) && filter.matches(nullId) && filter.matches(old));
+    
+    filter.setNotNullColumns({"sensor_id"});
+    filter.setAllowedValues({{"status", {"active", "idle"}}});
+    filter.setExcludeValueFilters({{"status", {"idle"}}});
+    assert(filter.matches(active));
+    assert(!filter.matches(nullId));
+    assert(!filter.matches(old));
+    
+    // Bulk setters replace earlier checks; date bounds are inclusive
+    filter.setExcludeValueFilters({});
+    filter.setNotNullColumns({});
+    filter.setDateRange(100, 500);
+    assert(filter.matches(active) && filter.matches(nullId) && filter.matches(old));
+    filter.setDateRange(101, 0);
+    assert(!filter.matches(old));
+    assert(!filter.matches(Reading{{"status", "active"}}));  // no timestamp
+    
+    filter.setInvertFilter(true);
+    assert(filter.matches(old) && !filter.matches(active));
+    std::cout << "[PASS] test_filter_setters_replace_checks" << std::endl;
+}
+
 // ===== Tail Column Value Tests =====
 
 void test_tail_column_value_json_basic() {
@@ -579,6 +627,211 @@ void test_tail_column_value_chronological_order() {
     std::cout << "[PASS] test_tail_column_value_chronological_order" << std::endl;
 }
 
+void test_csv_quoted_newline_in_file() {
+    TempFile file(
+        "sensor_id,note\n"
+        "s1,\"two\nlines\"\n"
+        "\n"
+        "s2,plain\n",
+        ".csv"
+    );
+    
+    DataReader reader;
+    std::vector<std::string> notes;
+    std::vector<int> lineNums;
+    
+    reader.processFile(file.path, [&](const Reading& reading, int lineNum, const std::string&) {
+        notes.push_back(reading.at("note"));
+        lineNums.push_back(lineNum);
+    });
+    
+    assert(notes.size() == 2);
+    assert(notes[0] == "two\nlines");
+    assert(notes[1] == "plain");
+    // Line numbers count records, as in stream mode
+    assert(lineNums[0] == 2);
+    assert(lineNums[1] == 4);
+    std::cout << "[PASS] test_csv_quoted_newline_in_file" << std::endl;
+}
+
+// Collect (lineNum, field) pairs so chunked and sequential reads can be compared
+static std::vector<std::pair<int, std::string>> readAll(DataReader& reader, const std::string& path,
+                                                        const std::string& field) {
+    std::vector<std::pair<int, std::string>> rows;
+    reader.processFile(path, [&](const Reading& reading, int lineNum, const std::string&) {
+        auto it = reading.find(field);
+        rows.emplace_back(lineNum, it != reading.end() ? it->second : "");
+    });
+    return rows;
+}
+
+void test_chunked_json_matches_sequential() {
+    std::string content;
+    for (int i = 0; i < 500; ++i) {
+        if (i % 7 == 0) content += "\n";
+        content += "{\"sensor_id\":\"s" + std::to_string(i % 3) + "\",\"value\":\"" + std::to_string(i) + "\"}\n";
+    }
+    TempFile file(content);
+    
+    DataReader sequential;
+    sequential.getFilter().addExcludeValueFilter("sensor_id", "s1");
+    DataReader chunked;
+    chunked.getFilter().addExcludeValueFilter("sensor_id", "s1");
+    chunked.setChunkThreads(4, 256);
+    
+    auto expected = readAll(sequential, file.path, "value");
+    auto actual = readAll(chunked, file.path, "value");
+    assert(!expected.empty());
+    assert(actual == expected);
+    std::cout << "[PASS] test_chunked_json_matches_sequential" << std::endl;
+}
+
+void test_chunked_csv_quoted_newlines() {
+    std::string content = "sensor_id,note\n";
+    for (int i = 0; i < 300; ++i) {
+        content += "s" + std::to_string(i) + ",\"row " + std::to_string(i) + "\nsecond \"\"line\"\"\"\n";
+    }
+    TempFile file(content, ".csv");
+    
+    DataReader sequential;
+    DataReader chunked;
+    chunked.setChunkThreads(3, 100);
+    
+    auto expected = readAll(sequential, file.path, "note");
+    auto actual = readAll(chunked, file.path, "note");
+    assert(expected.size() == 300);
+    assert(actual == expected);
+    std::cout << "[PASS] test_chunked_csv_quoted_newlines" << std::endl;
+}
+
+void test_chunked_unique_keeps_first() {
+    std::string content;
+    for (int i = 0; i < 400; ++i) {
+        content += "{\"sensor_id\":\"s" + std::to_string(i % 10) + "\"}\n";
+    }
+    TempFile file(content);
+    
+    DataReader reader;
+    reader.getFilter().setUniqueRows(true);
+    reader.setChunkThreads(4, 64);
+    
+    auto rows = readAll(reader, file.path, "sensor_id");
+    assert(rows.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+        assert(rows[i].first == i + 1);
+        assert(rows[i].second == "s" + std::to_string(i));
+    }
+    std::cout << "[PASS] test_chunked_unique_keeps_first" << std::endl;
+}
+
+void test_prefilter_skips_only_non_matching_lines() {
+    TempFile json(
+        "{\"sensor_id\":\"s1\",\"value\":\"10\"}\n"
+        "{\"sensor_id\":\"s2\",\"value\":\"20\"}\n"
+        "{\"sensor_id\":\"s2\",\"note\":\"s1\",\"value\":\"30\"}\n"
+        "{\"sensor_id\":\"s1\",\"value\":\"40\"}\n"
+    );
+    // The record on lines 2-3 only names s1 on its second line
+    TempFile csv(
+        "note,sensor_id,value\n"
+        "\"first\nline\",s1,10\n"
+        "plain,s2,20\n"
+        "s1,s2,30\n"
+        "plain,s1,40\n",
+        ".csv"
+    );
+    
+    for (const std::string* path : {&json.path, &csv.path}) {
+        DataReader reader;
+        reader.getFilter().addOnlyValueFilter("sensor_id", "s1");
+        assert(reader.getFilter().rawLinePrefilter() != nullptr);
+        DataReader chunked;
+        chunked.getFilter().addOnlyValueFilter("sensor_id", "s1");
+        chunked.setChunkThreads(2, 16);
+        
+        auto rows = readAll(reader, *path, "value");
+        assert(rows.size() == 2);
+        assert(rows[0].second == "10" && rows[1].second == "40");
+        assert(readAll(chunked, *path, "value") == rows);
+        
+        // Rejected rows are wanted as well when the filter is inverted
+        DataReader rejects;
+        rejects.getFilter().addOnlyValueFilter("sensor_id", "s1");
+        rejects.getFilter().setInvertFilter(true);
+        assert(rejects.getFilter().rawLinePrefilter() == nullptr);
+        assert(readAll(rejects, *path, "value").size() == 2);
+    }
+    
+    // Quotes and carriage returns in the middle of a CSV field are dropped,
+    // so s"1"x and s1<CR>x are both s1x
+    TempFile midQuote(
+        "note,sensor_id,value\n"
+        "plain,s\"1\"x,50\n"
+        "plain,s2,60\n",
+        ".csv"
+    );
+    TempFile midReturn(
+        "note,sensor_id,value\r\n"
+        "plain,s1\rx,50\r\n"
+        "plain,s2,60\r\n",
+        ".csv"
+    );
+    for (const std::string* path : {&midQuote.path, &midReturn.path}) {
+        DataReader reader;
+        reader.getFilter().addOnlyValueFilter("sensor_id", "s1x");
+        DataReader chunked;
+        chunked.getFilter().addOnlyValueFilter("sensor_id", "s1x");
+        chunked.setChunkThreads(2, 16);
+        auto rows = readAll(reader, *path, "value");
+        assert(rows.size() == 1 && rows[0].second == "50");
+        assert(readAll(chunked, *path, "value") == rows);
+    }
+    
+    // Values with a quote can differ from the raw line, so aren't prefiltered
+    ReadingFilter quoted;
+    quoted.addOnlyValueFilter("note", "say \"hi\"");
+    assert(quoted.rawLinePrefilter() == nullptr);
+    std::cout << "[PASS] test_prefilter_skips_only_non_matching_lines" << std::endl;
+}
+
+void test_required_columns_keep_filter_columns() {
+    TempFile json(
+        "{\"sensor_id\":\"s1\",\"status\":\"ok\",\"value\":\"10\"}\n"
+        "{\"sensor_id\":\"s2\",\"status\":\"bad\",\"value\":\"20\"}\n"
+    );
+    TempFile csv(
+        "sensor_id,status,value\n"
+        "s1,ok,10\n"
+        "s2,bad,20\n",
+        ".csv"
+    );
+    
+    for (const std::string* path : {&json.path, &csv.path}) {
+        DataReader reader;
+        reader.getFilter().addExcludeValueFilter("status", "bad");
+        reader.setRequiredColumns({"value"});
+        
+        std::vector<Reading> readings;
+        reader.processFile(*path, [&](const Reading& reading, int, const std::string&) {
+            readings.push_back(reading);
+        });
+        // The excluded row is still filtered; sensor_id is never parsed
+        assert(readings.size() == 1);
+        assert(readings[0].size() == 2);
+        assert(readings[0].at("value") == "10");
+        assert(readings[0].at("status") == "ok");
+        assert(readings[0].count("sensor_id") == 0);
+        
+        // --unique fingerprints whole rows, so every column is kept
+        DataReader unique;
+        unique.getFilter().setUniqueRows(true);
+        unique.setRequiredColumns({"value"});
+        auto rows = readAll(unique, *path, "sensor_id");
+        assert(rows.size() == 2 && rows[0].second == "s1");
+    }
+    std::cout << "[PASS] test_required_columns_keep_filter_columns" << std::endl;
+}
+
 int main() {
     std::cout << "================================" << std::endl;
     std::cout << "DataReader Unit Tests" << std::endl;
@@ -620,7 +873,9 @@ int main() {
     test_not_empty_filter();
     test_remove_errors_filter();
     test_unique_rows_filter();
+    test_unique_exact_rows_filter();
     test_combined_filters();
+    test_filter_setters_replace_checks();
     
     // Tail column value
     test_tail_column_value_json_basic();
@@ -629,6 +884,12 @@ int main() {
     test_tail_column_value_no_matches();
     test_tail_column_value_with_filter();
     test_tail_column_value_chronological_order();
+    test_csv_quoted_newline_in_file();
+    test_chunked_json_matches_sequential();
+    test_chunked_csv_quoted_newlines();
+    test_chunked_unique_keeps_first();
+    test_prefilter_skips_only_non_matching_lines();
+    test_required_columns_keep_filter_columns();
     
     std::cout << "================================" << std::endl;
     std::cout << "All DataReader tests passed!" << std::endl;
@@ -1,7 +1,9 @@
 #include "../include/date_utils.h"
 #include <cassert>
 #include <iostream>
+#include <cstdlib>
 #include <ctime>
+#include <string>
 
 void test_parse_unix_timestamp() {
     // Unix timestamp
@@ -390,6 +392,80 @@ void test_get_time_info_negative() {
     std::cout << "[PASS] test_get_time_info_negative" << std::endl;
 }
 
+// The fast path must agree with mktime() (tm_isdst = 0) on every hour of
+// the year, including across the daylight saving changes of a zone that has them
+void test_parse_matches_mktime() {
+    const char* savedTz = getenv("TZ");
+    std::string oldTz = savedTz ? savedTz : "";
+    setenv("TZ", "Europe/London", 1);
+    tzset();
+    
+    for (long long t = 1672531200; t < 1672531200 + 366LL * 86400; t += 3600 + 17 * 60 + 13) {
+        time_t tt = static_cast<time_t>(t);
+        struct tm utc;
+        gmtime_r(&tt, &utc);
+        char buf[32];
+        strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &utc);
+        
+        struct tm local = {};
+        local.tm_year = utc.tm_year;
+        local.tm_mon = utc.tm_mon;
+        local.tm_mday = utc.tm_mday;
+        local.tm_hour = utc.tm_hour;
+        local.tm_min = utc.tm_min;
+        local.tm_sec = utc.tm_sec;
+        assert(DateUtils::parseDate(buf) == static_cast<long long>(mktime(&local)));
+    }
+    
+    if (savedTz) {
+        setenv("TZ", oldTz.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+    
+    // Forms the fast path leaves to sscanf still parse as before
+    assert(DateUtils::parseDate("2026-01-17 14:30:00") == DateUtils::parseDate("2026-01-17"));
+    assert(DateUtils::parseDate("2026-01-17T14") == DateUtils::parseDate("2026-01-17T14:00:00"));
+    assert(DateUtils::parseDate("2026-01-017") == DateUtils::parseDate("2026-01-17"));
+    assert(DateUtils::parseDate("1234567890123456789") == 1234567890123456789LL);
+    assert(DateUtils::parseDate("99999999999999999999") == 0);  // out of range
+    assert(DateUtils::parseDate("-") == 0);
+    assert(DateUtils::parseDate("17e5") == 0);
+    std::cout << "[PASS] test_parse_matches_mktime" << std::endl;
+}
+
+// Period keys must give the labels gmtime_r() does, across leap years and
+// ISO week-year boundaries
+void test_period_labels_match_gmtime() {
+    for (long long t = 1; t < 4102444800LL; t += 86400 * 3 + 3607) {
+        time_t tt = static_cast<time_t>(t);
+        struct tm utc;
+        gmtime_r(&tt, &utc);
+        char hour[32], day[32], week[32], month[32], year[32];
+        strftime(hour, sizeof(hour), "%Y-%m-%d %H:00", &utc);
+        strftime(day, sizeof(day), "%Y-%m-%d", &utc);
+        strftime(week, sizeof(week), "%G-W%V", &utc);
+        strftime(month, sizeof(month), "%Y-%m", &utc);
+        strftime(year, sizeof(year), "%Y", &utc);
+        using DateUtils::Period;
+        assert(DateUtils::periodLabel(DateUtils::periodKey(t, Period::Hour), Period::Hour) == hour);
+        assert(DateUtils::timestampToDay(t) == day);
+        assert(DateUtils::timestampToWeek(t) == week);
+        assert(DateUtils::timestampToMonth(t) == month);
+        assert(DateUtils::timestampToYear(t) == year);
+    }
+    
+    using DateUtils::Period;
+    assert(DateUtils::periodKey(0, Period::Day) == DateUtils::NO_PERIOD);
+    assert(DateUtils::periodKey(-86400, Period::Week) == DateUtils::NO_PERIOD);
+    assert(DateUtils::periodKey(1LL << 62, Period::Year) == DateUtils::NO_PERIOD);
+    assert(DateUtils::periodKey(1704067200, Period::Month) < DateUtils::periodKey(1706745600, Period::Month));
+    assert(DateUtils::periodKey(1704067200 + 3599, Period::Hour) == DateUtils::periodKey(1704067200, Period::Hour));
+    assert(DateUtils::periodKey(1704067200 + 3600, Period::Hour) == DateUtils::periodKey(1704067200, Period::Hour) + 1);
+    std::cout << "[PASS] test_period_labels_match_gmtime" << std::endl;
+}
+
 int main() {
     std::cout << "Running Date Utils Tests..." << std::endl;
     
@@ -398,6 +474,7 @@ int main() {
     test_parse_iso_date();
     test_parse_iso_datetime();
     test_parse_uk_date();
+    test_parse_matches_mktime();
     test_parse_empty_string();
     test_parse_negative_unix_timestamp();
     
@@ -446,6 +523,7 @@ int main() {
     test_timestamp_to_week();
     test_timestamp_to_week_first_week();
     test_timestamp_to_week_invalid();
+    test_period_labels_match_gmtime();
     
     // getTimeInfo tests
     test_get_time_info_valid();
@@ -216,6 +216,28 @@ void test_read_lines_reverse_long_lines() {
     std::cout << "[PASS] test_read_lines_reverse_long_lines" << std::endl;
 }
 
+void test_mapped_file_contents() {
+    TempFile file("line1\nline2\n");
+    MappedFile mapped;
+    bool opened = mapped.open(file.path);
+    assert(opened);
+    assert(mapped.data() == "line1\nline2\n");
+    mapped.close();
+    assert(mapped.data().empty());
+    std::cout << "[PASS] test_mapped_file_contents" << std::endl;
+}
+
+void test_mapped_file_empty_and_missing() {
+    TempFile file("");
+    MappedFile mapped;
+    bool opened = mapped.open(file.path);
+    assert(opened);
+    assert(mapped.data().empty());
+    bool openedMissing = mapped.open("nonexistent_file_12345.txt");
+    assert(!openedMissing);
+    std::cout << "[PASS] test_mapped_file_empty_and_missing" << std::endl;
+}
+
 int main() {
     std::cout << "Running File Utils Tests..." << std::endl;
     test_is_csv_file();
@@ -237,6 +259,10 @@ int main() {
     test_read_lines_reverse_with_special_chars();
     test_read_lines_reverse_long_lines();
     
+    // MappedFile tests
+    test_mapped_file_contents();
+    test_mapped_file_empty_and_missing();
+    
     std::cout << "All File Utils tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,173 @@
+#include "../include/fingerprint.h"
+#include "../include/seen_row_set.h"
+#include "../include/spilling_fingerprint_set.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void test_field_order_does_not_matter() {
+    Reading a{{"sensor_id", "s1"}, {"value", "22.5"}, {"unit", "C"}};
+    Reading b{{"unit", "C"}, {"sensor_id", "s1"}, {"value", "22.5"}};
+    assert(Fingerprint::of(a) == Fingerprint::of(b));
+    std::cout << "[PASS] test_field_order_does_not_matter" << std::endl;
+}
+
+void test_different_rows_differ() {
+    Reading base{{"sensor_id", "s1"}, {"value", "22.5"}};
+    assert(Fingerprint::of(base) != Fingerprint::of(Reading{{"sensor_id", "s1"}, {"value", "22.6"}}));
+    // Swapping values between keys changes the row
+    assert(Fingerprint::of(base) != Fingerprint::of(Reading{{"sensor_id", "22.5"}, {"value", "s1"}}));
+    // A missing field and an empty one are different rows
+    assert(Fingerprint::of(Reading{{"sensor_id", "s1"}}) !=
+           Fingerprint::of(Reading{{"sensor_id", "s1"}, {"unit", ""}}));
+    assert(Fingerprint::of(Reading()) != Fingerprint::of(Reading{{"unit", ""}}));
+    std::cout << "[PASS] test_different_rows_differ" << std::endl;
+}
+
+void test_hash_covers_every_byte() {
+    // Exercise whole 16-byte blocks and every tail length
+    std::string text(40, 'a');
+    for (size_t len = 0; len < text.size(); ++len) {
+        Fingerprint before = Fingerprint::hashBytes(text.data(), len, 1);
+        for (size_t i = 0; i < len; ++i) {
+            text[i] = 'b';
+            assert(Fingerprint::hashBytes(text.data(), len, 1) != before);
+            text[i] = 'a';
+        }
+        assert(Fingerprint::hashBytes(text.data(), len, 2) != before);
+    }
+    std::cout << "[PASS] test_hash_covers_every_byte" << std::endl;
+}
+
+void test_set_insert_and_grow() {
+    FingerprintSet set;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        std::string value = std::to_string(i);
+        bool inserted = set.insert(Fingerprint::of(Reading{{"value", value}}));
+        assert(inserted);
+    }
+    assert(set.size() == 10000);
+    for (uint64_t i = 0; i < 10000; ++i) {
+        std::string value = std::to_string(i);
+        Fingerprint fp = Fingerprint::of(Reading{{"value", value}});
+        assert(set.contains(fp));
+        bool inserted = set.insert(fp);
+        assert(!inserted);
+    }
+    assert(!set.contains(Fingerprint::of(Reading{{"value", "10000"}})));
+    assert(set.size() == 10000);
+
+    // The all-zero fingerprint marks free slots but can still be stored
+    bool first = set.insert(Fingerprint());
+    assert(first);
+    assert(set.contains(Fingerprint()));
+    bool again = set.insert(Fingerprint());
+    assert(!again);
+
+    set.clear();
+    assert(set.size() == 0);
+    bool afterClear = set.insert(Fingerprint::of(Reading{{"value", "1"}}));
+    assert(afterClear);
+    std::cout << "[PASS] test_set_insert_and_grow" << std::endl;
+}
+
+void test_seen_row_set_concurrent_claims() {
+    std::vector<Fingerprint> rows;
+    for (int i = 0; i < 20000; ++i) {
+        rows.push_back(Fingerprint::of(Reading{{"value", std::to_string(i)}}));
+    }
+
+    // Every thread tries to claim every row; each row is won exactly once
+    SeenRowSet seen;
+    std::atomic<int> claimed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < rows.size(); ++i) {
+                const Fingerprint& fp = rows[(i + t * 2500) % rows.size()];
+                if (seen.insert(fp)) ++claimed;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(claimed == 20000);
+    assert(seen.size() == 20000);
+
+    // Exact rows are compared in full, even if fingerprints collide
+    Fingerprint same = rows[0];
+    bool a = seen.insert(same, "a");
+    bool b = seen.insert(same, "b");
+    bool aAgain = seen.insert(same, "a");
+    assert(a && b && !aAgain);
+
+    seen.clear();
+    assert(seen.size() == 0);
+    bool afterClear = seen.insert(rows[0]);
+    assert(afterClear);
+    std::cout << "[PASS] test_seen_row_set_concurrent_claims" << std::endl;
+}
+
+void test_spilling_set_matches_in_memory_set() {
+    // Smallest budget, so the table spills every few thousand fingerprints
+    SpillingFingerprintSet spilling(1);
+    FingerprintSet reference;
+    uint64_t state = 12345;
+    for (int i = 0; i < 200000; ++i) {
+        // Draw from a range a little larger than the row count, so many repeat
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::string value = std::to_string((state >> 33) % 150000);
+        Fingerprint fp = Fingerprint::of(Reading{{"value", value}});
+        bool spilledNew = spilling.insert(fp);
+        bool referenceNew = reference.insert(fp);
+        assert(spilledNew == referenceNew);
+    }
+    assert(spilling.size() == reference.size());
+    assert(spilling.runCount() > 0);
+    assert(spilling.runCount() < 16);  // runs get merged
+
+    // The all-zero fingerprint is stored like any other
+    bool first = spilling.insert(Fingerprint());
+    bool again = spilling.insert(Fingerprint());
+    assert(first && !again);
+
+    spilling.clear();
+    assert(spilling.size() == 0);
+    assert(spilling.runCount() == 0);
+    bool afterClear = spilling.insert(Fingerprint::of(Reading{{"value", "1"}}));
+    assert(afterClear);
+    std::cout << "[PASS] test_spilling_set_matches_in_memory_set" << std::endl;
+}
+
+void test_seen_row_set_memory_limit() {
+    SeenRowSet seen;
+    seen.setMemoryLimit(1);
+    std::atomic<int> claimed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 20000; ++i) {
+                if (seen.insert(Fingerprint::of(Reading{{"value", std::to_string(i)}}))) ++claimed;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(claimed == 20000);
+    assert(seen.size() == 20000);
+    std::cout << "[PASS] test_seen_row_set_memory_limit" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Fingerprint Tests..." << std::endl;
+    test_field_order_does_not_matter();
+    test_different_rows_differ();
+    test_hash_covers_every_byte();
+    test_set_insert_and_grow();
+    test_seen_row_set_concurrent_claims();
+    test_spilling_set_matches_in_memory_set();
+    test_seen_row_set_memory_limit();
+    std::cout << "All Fingerprint tests passed!" << std::endl;
+    return 0;
+}
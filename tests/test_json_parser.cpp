@@ -215,6 +215,76 @@ void test_json_unicode_string() {
     std::cout << "[PASS] test_json_unicode_string" << std::endl;
 }
 
+void test_json_views_point_into_line() {
+    std::string line = R"([{"sensor_id": "s1", "value": 22.5}, {"sensor_id": "s2", "value": "x"}])";
+    JsonLineViews views;
+    JsonParser::parseJsonLineViews(line, views);
+    assert(views.size() == 2);
+    assert(views[0].size() == 2);
+    assert(views[0].begin()->key == "sensor_id");
+    assert(views[0].begin()->value == "s1");
+    assert(views[1].begin()[1].value == "x");
+    // Views reference the original buffer rather than copies
+    const char* base = line.data();
+    const char* v = views[0].begin()->value.data();
+    assert(v >= base && v < base + line.size());
+    std::cout << "[PASS] test_json_views_point_into_line" << std::endl;
+}
+
+void test_json_views_reuse_clears_previous_line() {
+    JsonLineViews views;
+    std::string first = R"([{"a": 1}, {"b": 2}, {"c": 3}])";
+    std::string second = R"({"d": 4})";
+    JsonParser::parseJsonLineViews(first, views);
+    assert(views.size() == 3);
+    JsonParser::parseJsonLineViews(second, views);
+    assert(views.size() == 1);
+    assert(views[0].begin()->key == "d");
+    JsonParser::parseJsonLineViews("[]", views);
+    assert(views.empty());
+    std::cout << "[PASS] test_json_views_reuse_clears_previous_line" << std::endl;
+}
+
+void test_json_views_match_parse_json_line() {
+    std::string line = R"({"a": [1, [2]], "b": {"c": "}"}, "d": 7 , "e": "q\"x"})";
+    JsonLineViews views;
+    JsonParser::parseJsonLineViews(line, views);
+    auto result = JsonParser::parseJsonLine(line);
+    assert(views.size() == 1 && result.size() == 1);
+    Reading reading;
+    JsonParser::toReading(views[0], reading);
+    assert(reading == result[0]);
+    assert(reading["a"] == "1, [2]");
+    assert(reading["b"] == R"({"c": "}"})");
+    assert(reading["d"] == "7");
+    std::cout << "[PASS] test_json_views_match_parse_json_line" << std::endl;
+}
+
+void test_json_views_duplicate_key_first_wins() {
+    std::string line = R"({"k": "first", "k": "second"})";
+    JsonLineViews views;
+    JsonParser::parseJsonLineViews(line, views);
+    Reading reading;
+    JsonParser::toReading(views[0], reading);
+    assert(reading.size() == 1);
+    assert(reading["k"] == "first");
+    std::cout << "[PASS] test_json_views_duplicate_key_first_wins" << std::endl;
+}
+
+void test_json_views_projected_reading() {
+    std::string line = R"({"sensor_id": "s1", "value": 21.5, "unit": "C"})";
+    JsonLineViews views;
+    JsonParser::parseJsonLineViews(line, views);
+    Reading reading;
+    JsonParser::toReading(views[0], reading, ColumnProjection({Keys::Value, Keys::Timestamp}));
+    assert(reading.size() == 1);
+    assert(reading[Keys::Value] == "21.5");
+    
+    JsonParser::toReading(views[0], reading, ColumnProjection());
+    assert(reading.size() == 3);
+    std::cout << "[PASS] test_json_views_projected_reading" << std::endl;
+}
+
 int main() {
     std::cout << "Running JSON Parser Tests..." << std::endl;
     test_simple_json();
@@ -239,6 +309,11 @@ int main() {
     test_json_whitespace_variations();
     test_json_integer_values();
     test_json_unicode_string();
+    test_json_views_point_into_line();
+    test_json_views_reuse_clears_previous_line();
+    test_json_views_match_parse_json_line();
+    test_json_views_duplicate_key_first_wins();
+    test_json_views_projected_reading();
     std::cout << "All JSON Parser tests passed!" << std::endl;
     return 0;
 }
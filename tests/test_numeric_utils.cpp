@@ -0,0 +1,101 @@
+#include "../include/numeric_utils.h"
+#include <cassert>
+#include <clocale>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// parseDouble accepts a string exactly when std::stod consumes all of it
+// and gives a finite number
+static bool stodAccepts(const std::string& str) {
+    try {
+        size_t pos = 0;
+        double value = std::stod(str, &pos);
+        return pos == str.length() && std::isfinite(value);
+    } catch (...) {
+        return false;
+    }
+}
+
+void test_parse_double_values() {
+    assert(NumericUtils::parseDouble("22.5") == 22.5);
+    assert(NumericUtils::parseDouble("-127") == -127.0);
+    assert(NumericUtils::parseDouble("+85") == 85.0);
+    assert(NumericUtils::parseDouble("1.5e10") == 1.5e10);
+    assert(NumericUtils::parseDouble(".5") == 0.5);
+    assert(NumericUtils::parseDouble("  42") == 42.0);
+    assert(NumericUtils::parseDouble("0x1p4") == 16.0);
+    assert(NumericUtils::parseDouble("-0X10") == -16.0);
+    std::cout << "[PASS] test_parse_double_values" << std::endl;
+}
+
+void test_parse_double_rejects() {
+    for (const char* str : {"", " ", "null", "NULL", "85C", "22.5 ", "1,5", "+-1", "--1", "+", "-",
+                            "0x", "0x+1", "e5", "1e", "1e999", "-1e999", "nanx", "\t",
+                            "nan", "-nan", "NaN", "inf", "-inf", "Infinity", "nan(1)"}) {
+        assert(!NumericUtils::parseDouble(str));
+    }
+    std::cout << "[PASS] test_parse_double_rejects" << std::endl;
+}
+
+void test_parse_double_matches_stod() {
+    for (const char* str : {"0", "-0", "007", "1.", ".", "1e+3", "1E-3", "infinity", "INF", "NaN", " \n7",
+                            "+.5", "+nan", "-0x1.8p1", "0x1g", "12abc", "1e-400", "1.7976931348623157e308"}) {
+        auto parsed = NumericUtils::parseDouble(str);
+        assert(parsed.has_value() == stodAccepts(str));
+        if (parsed) assert(*parsed == std::stod(str));
+    }
+    std::cout << "[PASS] test_parse_double_matches_stod" << std::endl;
+}
+
+void test_parse_double_prefix_matches_stod() {
+    for (const char* str : {"85C", "22.5 ", "  -127x", "1e", "1e+", "0x", "0xg", "0x1p4z", "+.5,", "12abc",
+                            "nan", "-inf", "infinityx", "1,5", "", "C85", "+-1", "1e999", "-", "."}) {
+        auto parsed = NumericUtils::parseDoublePrefix(str);
+        bool stodOk = true;
+        double expected = 0.0;
+        try {
+            expected = std::stod(str);
+        } catch (...) {
+            stodOk = false;
+        }
+        assert(parsed.has_value() == stodOk);
+        if (parsed) assert(*parsed == expected || (std::isnan(*parsed) && std::isnan(expected)));
+    }
+    std::cout << "[PASS] test_parse_double_prefix_matches_stod" << std::endl;
+}
+
+void test_parse_double_ignores_locale() {
+    // A locale with a decimal comma, if the system has one
+    if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") || std::setlocale(LC_NUMERIC, "fr_FR.UTF-8")) {
+        assert(NumericUtils::parseDouble("22.5") == 22.5);
+        assert(!NumericUtils::parseDouble("22,5"));
+        std::setlocale(LC_NUMERIC, "C");
+    }
+    std::cout << "[PASS] test_parse_double_ignores_locale" << std::endl;
+}
+
+void test_parse_integer() {
+    assert(NumericUtils::parseInteger("1700000000") == 1700000000LL);
+    assert(NumericUtils::parseInteger("-5") == -5LL);
+    assert(NumericUtils::parseInteger("9007199254740993") == 9007199254740993LL);  // not a double
+    assert(NumericUtils::parseInteger("1700000000.9") == 1700000000LL);
+    assert(NumericUtils::parseInteger("-2.5") == -2LL);
+    assert(NumericUtils::parseInteger("1.7e9") == 1700000000LL);
+    assert(!NumericUtils::parseInteger("null"));
+    assert(!NumericUtils::parseInteger("nan"));
+    assert(!NumericUtils::parseInteger("inf"));
+    assert(!NumericUtils::parseInteger("1e30"));
+    std::cout << "[PASS] test_parse_integer" << std::endl;
+}
+
+int main() {
+    test_parse_double_values();
+    test_parse_double_rejects();
+    test_parse_double_matches_stod();
+    test_parse_double_prefix_matches_stod();
+    test_parse_double_ignores_locale();
+    test_parse_integer();
+    std::cout << "All numeric utils tests passed!" << std::endl;
+    return 0;
+}
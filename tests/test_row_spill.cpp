@@ -0,0 +1,65 @@
+#include "../include/row_spill.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+void test_replay_in_order() {
+    RowSpill spill;
+    assert(spill.isOpen());
+    RowSpill::encode(Reading{{"sensor_id", "s1"}, {"value", "22.5"}}, spill.stream());
+    RowSpill::encode(Reading{{"sensor_id", "s2"}, {"unit", "C"}, {"value", ""}}, spill.stream());
+
+    std::vector<Reading> rows;
+    bool replayed = spill.replay([&](const Reading& reading) { rows.push_back(reading); });
+    assert(replayed);
+    assert(rows.size() == 2);
+    assert(rows[0].size() == 2);
+    assert(rows[0].at("sensor_id") == "s1");
+    assert(rows[0].at("value") == "22.5");
+    assert(rows[1].size() == 3);
+    assert(rows[1].at("unit") == "C");
+    assert(rows[1].at("value").empty());
+    std::cout << "[PASS] test_replay_in_order" << std::endl;
+}
+
+void test_values_are_binary_safe() {
+    RowSpill spill;
+    std::string awkward("a,\"b\"\nc\0d", 9);
+    RowSpill::encode(Reading{{"note", awkward}}, spill.stream());
+
+    int count = 0;
+    bool replayed = spill.replay([&](const Reading& reading) {
+        assert(reading.at("note") == awkward);
+        count++;
+    });
+    assert(replayed);
+    assert(count == 1);
+    std::cout << "[PASS] test_values_are_binary_safe" << std::endl;
+}
+
+void test_empty_rows_and_spill() {
+    RowSpill empty;
+    int count = 0;
+    bool replayed = empty.replay([&](const Reading&) { count++; });
+    assert(replayed);
+    assert(count == 0);
+
+    RowSpill spill;
+    RowSpill::encode(Reading(), spill.stream());
+    replayed = spill.replay([&](const Reading& reading) {
+        assert(reading.empty());
+        count++;
+    });
+    assert(replayed);
+    assert(count == 1);
+    std::cout << "[PASS] test_empty_rows_and_spill" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Row Spill Tests..." << std::endl;
+    test_replay_in_order();
+    test_values_are_binary_safe();
+    test_empty_rows_and_spill();
+    std::cout << "All Row Spill tests passed!" << std::endl;
+    return 0;
+}
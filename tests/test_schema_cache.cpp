@@ -0,0 +1,130 @@
+#include "../include/schema_cache.h"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+static const std::string cacheDir = "test_schema_cache_dir";
+static const std::string dataFile = "test_schema_cache_temp.out";
+
+static void writeData(const std::string& content) {
+    std::ofstream f(dataFile);
+    f << content;
+}
+
+static void cleanup() {
+    std::filesystem::remove_all(cacheDir);
+    std::remove(dataFile.c_str());
+}
+
+void test_round_trip() {
+    cleanup();
+    writeData("[ {\"sensor_id\":\"s1\"} ]\n");
+    std::set<std::string> keys = {"sensor_id", "value", "odd\tkey", ""};
+    {
+        SchemaCache cache(cacheDir, "filters");
+        cache.load();
+        auto stamp = SchemaCache::stampOf(dataFile);
+        std::set<std::string> found;
+        assert(!cache.lookup(dataFile, stamp, found));
+        cache.store(dataFile, stamp, keys);
+        bool saved = cache.save();
+        assert(saved);
+    }
+    SchemaCache cache(cacheDir, "filters");
+    cache.load();
+    std::set<std::string> found;
+    bool hit = cache.lookup(dataFile, SchemaCache::stampOf(dataFile), found);
+    assert(hit);
+    assert(found == keys);
+    cleanup();
+    std::cout << "[PASS] test_round_trip" << std::endl;
+}
+
+void test_changed_file_misses() {
+    cleanup();
+    writeData("[ {\"sensor_id\":\"s1\"} ]\n");
+    SchemaCache cache(cacheDir, "filters");
+    cache.store(dataFile, SchemaCache::stampOf(dataFile), {"sensor_id"});
+
+    std::set<std::string> found;
+    writeData("[ {\"sensor_id\":\"s1\"} ]\n[ {\"sensor_id\":\"s2\",\"unit\":\"C\"} ]\n");
+    assert(!cache.lookup(dataFile, SchemaCache::stampOf(dataFile), found));
+    cleanup();
+    std::cout << "[PASS] test_changed_file_misses" << std::endl;
+}
+
+void test_signature_separates_entries() {
+    cleanup();
+    writeData("[ {\"sensor_id\":\"s1\"} ]\n");
+    auto stamp = SchemaCache::stampOf(dataFile);
+    {
+        SchemaCache cache(cacheDir, "no filters");
+        cache.store(dataFile, stamp, {"sensor_id", "value"});
+        bool saved = cache.save();
+        assert(saved);
+    }
+    SchemaCache other(cacheDir, "--only-value sensor_id:s2");
+    other.load();
+    std::set<std::string> found;
+    assert(!other.lookup(dataFile, stamp, found));
+
+    SchemaCache same(cacheDir, "no filters");
+    same.load();
+    assert(same.lookup(dataFile, stamp, found));
+    cleanup();
+    std::cout << "[PASS] test_signature_separates_entries" << std::endl;
+}
+
+void test_missing_file_is_never_cached() {
+    cleanup();
+    auto stamp = SchemaCache::stampOf("does_not_exist.out");
+    assert(!stamp.valid);
+    SchemaCache cache(cacheDir, "");
+    cache.store("does_not_exist.out", stamp, {"sensor_id"});
+    std::set<std::string> found;
+    assert(!cache.lookup("does_not_exist.out", stamp, found));
+    bool saved = cache.save();
+    assert(saved);
+    assert(!std::filesystem::exists(cacheDir));
+    std::cout << "[PASS] test_missing_file_is_never_cached" << std::endl;
+}
+
+void test_save_drops_deleted_files() {
+    cleanup();
+    const std::string goneFile = "test_schema_cache_gone.out";
+    writeData("[ {\"sensor_id\":\"s1\"} ]\n");
+    std::ofstream(goneFile) << "[ {\"unit\":\"C\"} ]\n";
+    SchemaCache cache(cacheDir, "");
+    cache.store(dataFile, SchemaCache::stampOf(dataFile), {"sensor_id"});
+    cache.store(goneFile, SchemaCache::stampOf(goneFile), {"unit"});
+    std::remove(goneFile.c_str());
+    bool saved = cache.save();
+    assert(saved);
+
+    // One entry, and no temp file left beside the cache
+    std::ifstream in(cacheDir + "/schema-cache.tsv");
+    std::string line;
+    int lines = 0;
+    while (std::getline(in, line)) lines++;
+    assert(lines == 1);
+    int files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDir)) {
+        (void)entry;
+        files++;
+    }
+    assert(files == 1);
+    cleanup();
+    std::cout << "[PASS] test_save_drops_deleted_files" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Schema Cache Tests..." << std::endl;
+    test_round_trip();
+    test_changed_file_misses();
+    test_signature_separates_entries();
+    test_missing_file_is_never_cached();
+    test_save_drops_deleted_files();
+    std::cout << "All Schema Cache tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "../include/series_kernels.h"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+typedef std::function<SeriesMoments(const double*, size_t, double, double)> Kernel;
+
+static bool near(double a, double b, double tolerance = 1e-9) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+}
+
+// The one-value-at-a-time loops the kernels replace
+static SeriesMoments reference(const std::vector<double>& values, double lowerFence, double upperFence) {
+    SeriesMoments m;
+    m.count = values.size();
+    if (values.empty()) return m;
+    m.min = m.max = values[0];
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+        m.min = std::min(m.min, v);
+        m.max = std::max(m.max, v);
+        if (v < lowerFence || v > upperFence) m.outliers++;
+    }
+    m.mean = sum / values.size();
+    if (values.size() < 2) return m;
+    double squares = 0.0;
+    for (double v : values) squares += (v - m.mean) * (v - m.mean);
+    m.stddev = std::sqrt(squares / (values.size() - 1));
+
+    m.deltaCount = values.size() - 1;
+    m.deltaMin = m.deltaMax = std::abs(values[1] - values[0]);
+    m.maxJumpIndex = 1;
+    double deltaSum = 0.0;
+    for (size_t i = 1; i < values.size(); ++i) {
+        double delta = std::abs(values[i] - values[i - 1]);
+        deltaSum += delta;
+        m.deltaMin = std::min(m.deltaMin, delta);
+        if (delta > m.deltaMax) {
+            m.deltaMax = delta;
+            m.maxJumpIndex = i;
+        }
+    }
+    m.deltaMean = deltaSum / m.deltaCount;
+    if (m.deltaCount > 1) {
+        double deltaSquares = 0.0;
+        for (size_t i = 1; i < values.size(); ++i) {
+            double spread = std::abs(values[i] - values[i - 1]) - m.deltaMean;
+            deltaSquares += spread * spread;
+        }
+        m.deltaStddev = std::sqrt(deltaSquares / (m.deltaCount - 1));
+    }
+    return m;
+}
+
+static void assertMatches(const SeriesMoments& got, const SeriesMoments& want) {
+    assert(got.count == want.count);
+    assert(got.min == want.min && got.max == want.max);
+    assert(near(got.mean, want.mean));
+    assert(near(got.stddev, want.stddev, 1e-7));
+    assert(got.deltaCount == want.deltaCount);
+    assert(got.deltaMin == want.deltaMin && got.deltaMax == want.deltaMax);
+    assert(near(got.deltaMean, want.deltaMean));
+    assert(near(got.deltaStddev, want.deltaStddev, 1e-7));
+    assert(got.maxJumpIndex == want.maxJumpIndex);
+    assert(got.outliers == want.outliers);
+}
+
+static std::vector<Kernel> kernels() {
+    std::vector<Kernel> all = {SeriesKernels::moments128, SeriesKernels::compute};
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2")) all.push_back(SeriesKernels::momentsAvx2);
+#endif
+    return all;
+}
+
+void test_every_length_matches_reference() {
+    // Lengths either side of each lane count, with repeated values and ties
+    for (size_t n = 0; n <= 37; ++n) {
+        std::vector<double> values;
+        for (size_t i = 0; i < n; ++i) values.push_back(static_cast<double>((i * 37) % 11) * 0.5 - 1.0);
+        for (const auto& kernel : kernels()) {
+            assertMatches(kernel(values.data(), n, -0.5, 3.5), reference(values, -0.5, 3.5));
+        }
+    }
+    std::cout << "[PASS] test_every_length_matches_reference" << std::endl;
+}
+
+void test_first_largest_jump_wins() {
+    // Equal jumps in different lanes and in the scalar tail
+    std::vector<double> values = {0, 0, 0, 5, 5, 0, 0, 5, 0, 0, 0};
+    for (const auto& kernel : kernels()) {
+        SeriesMoments m = kernel(values.data(), values.size(), 0, 0);
+        assert(m.deltaMax == 5 && m.maxJumpIndex == 3);
+    }
+    std::vector<double> tail = {1, 1, 1, 1, 1, 1, 1, 1, 1, 4};  // the jump is after the last full vector
+    for (const auto& kernel : kernels()) {
+        SeriesMoments m = kernel(tail.data(), tail.size(), 0, 0);
+        assert(m.deltaMax == 3 && m.maxJumpIndex == 9);
+    }
+    std::cout << "[PASS] test_first_largest_jump_wins" << std::endl;
+}
+
+void test_large_offset_keeps_precision() {
+    // Two-pass variance: a small spread on a large value isn't lost
+    std::vector<double> values;
+    uint64_t state = 7;
+    for (int i = 0; i < 100001; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        values.push_back(1e9 + static_cast<double>(state >> 54) * 0.125);
+    }
+    SeriesMoments want = reference(values, 1e9 + 10, 1e9 + 100);
+    for (const auto& kernel : kernels()) {
+        assertMatches(kernel(values.data(), values.size(), 1e9 + 10, 1e9 + 100), want);
+    }
+    std::cout << "[PASS] test_large_offset_keeps_precision" << std::endl;
+}
+
+int main() {
+    test_every_length_matches_reference();
+    test_first_largest_jump_wins();
+    test_large_offset_keeps_precision();
+    std::cout << "All series kernel tests passed!" << std::endl;
+    return 0;
+}
@@ -181,6 +181,27 @@ else
     FAILED=$((FAILED + 1))
 fi
 
+# Test 8b: nan and inf aren't numbers
+echo ""
+echo "Test 8b: nan and inf values are skipped"
+input='{"sensor_id":"s1","value":"20.0"}
+{"sensor_id":"s1","value":"nan"}
+{"sensor_id":"s1","value":"inf"}
+{"sensor_id":"s1","value":"-Infinity"}
+{"sensor_id":"s1","value":"22.0"}'
+result=$(echo "$input" | ./sensor-data stats)
+csv=$(echo "$input" | ./sensor-data stats -b sensor_id -of csv)
+if echo "$result" | grep -q "Count:.*2" && echo "$result" | grep -q "Mean:.*21" && \
+   ! echo "$result$csv" | grep -qi "nan\|inf" && echo "$csv" | grep -q "^s1,value,2,"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected only the two finite values to be counted"
+    echo "  Got: $result"
+    echo "  CSV: $csv"
+    FAILED=$((FAILED + 1))
+fi
+
 # Test 9: Multiple columns
 echo ""
 echo "Test 9: Analyze specific non-default column"
@@ -741,6 +762,273 @@ else
     FAILED=$((FAILED + 1))
 fi
 
+# Test 39: --unique keeps the first occurrence in file order with -j
+echo ""
+echo "Test 39: --unique with -j4 matches -j1"
+UNIQUE_DIR=$(mktemp -d)
+for f in 1 2 3 4 5 6; do
+    for i in $(seq 1 200); do
+        echo "{\"timestamp\":\"$((f * 1000 + i))\",\"value\":\"$(( (i * f) % 37 ))\"}"
+        # Rows repeated from earlier files move the deltas if the wrong copy wins
+        echo "{\"timestamp\":\"$(( (f % 3 + 1) * 1000 + i ))\",\"value\":\"$(( (i * (f % 3 + 1)) % 37 ))\"}"
+    done > "$UNIQUE_DIR/part$f.out"
+done
+result_j1=$(./sensor-data stats --unique -j 1 "$UNIQUE_DIR" 2>&1)
+result_j4=$(./sensor-data stats --unique -j 4 "$UNIQUE_DIR" 2>&1)
+rm -rf "$UNIQUE_DIR"
+if [ "$result_j1" = "$result_j4" ] && echo "$result_j1" | grep -q "Count:.*1200"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --unique stats should not depend on -j"
+    echo "  -j1: $result_j1"
+    echo "  -j4: $result_j4"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 40: --streaming is exact below the sketch size
+echo ""
+echo "Test 40: --streaming matches exact stats on small input"
+STREAM_DIR=$(mktemp -d)
+for i in $(seq 1 150); do
+    echo "{\"timestamp\":\"$((1700000000 + i * 60 + (i > 100 ? 3600 : 0)))\",\"value\":\"$(( (i * 13) % 41 )).5\",\"humidity\":\"$((i % 9))\"}"
+done > "$STREAM_DIR/small.out"
+result_exact=$(./sensor-data stats -c all "$STREAM_DIR/small.out" 2>&1)
+result_stream=$(./sensor-data stats -c all --streaming "$STREAM_DIR/small.out" 2>&1)
+if [ "$result_exact" = "$result_stream" ] && echo "$result_exact" | grep -q "Count:.*150"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --streaming should match exact stats below 200 values"
+    diff <(echo "$result_exact") <(echo "$result_stream")
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 41: --streaming merges per-file state in file order
+echo ""
+echo "Test 41: --streaming with -j4 matches -j1 and exact counts"
+for f in 1 2 3 4 5 6; do
+    for i in $(seq 1 400); do
+        echo "{\"timestamp\":\"$((1700000000 + f * 100000 + i * 30))\",\"value\":\"$(( (i * f * 7) % 53 ))\"}"
+    done > "$STREAM_DIR/part$f.out"
+done
+rm -f "$STREAM_DIR/small.out"
+result_j1=$(./sensor-data stats --streaming -j 1 "$STREAM_DIR" 2>&1)
+result_j4=$(./sensor-data stats --streaming -j 4 "$STREAM_DIR" 2>&1)
+result_exact=$(./sensor-data stats -j 4 "$STREAM_DIR" 2>&1)
+rm -rf "$STREAM_DIR"
+same_lines() {
+    [ "$(echo "$result_exact" | grep "$1")" = "$(echo "$result_j1" | grep "$1")" ]
+}
+if [ "$result_j1" = "$result_j4" ] && echo "$result_j1" | grep -q "Quartiles (estimated)" && \
+   same_lines "Count:" && same_lines "Min:" && same_lines "Max:" && same_lines "Mean:" && \
+   same_lines "First:" && same_lines "Last:" && same_lines "From:"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --streaming should not depend on -j, and exact fields should match"
+    diff <(echo "$result_exact") <(echo "$result_j1")
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 42: --refresh-every throttles follow-mode output
+echo ""
+echo "Test 42: --follow --refresh-every prints every n readings and when input runs dry"
+result=$(for i in $(seq 1 10); do echo "{\"value\":\"$i\"}"; done | timeout 2 ./sensor-data stats -f --refresh-every 4 2>&1) || true
+counts=$(echo "$result" | grep "^  Count:" | tr -s ' ' | cut -d' ' -f3 | tr '\n' ' ')
+refreshes=$(echo "$result" | grep -c "^---")
+if [ "$counts" = "4 8 10 " ] && [ "$refreshes" -eq 4 ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected counts 4 8 10 in 4 refreshes, got '$counts' in $refreshes"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 43: following a file reads its existing content once
+echo ""
+echo "Test 43: --follow on a file counts existing readings once"
+FOLLOW_FILE=$(mktemp --suffix=.out)
+printf '{"value":"1"}\n{"value":"2"}\n{"value":"3"}\n' > "$FOLLOW_FILE"
+result=$(timeout 1 ./sensor-data stats -f "$FOLLOW_FILE" 2>&1) || true
+rm -f "$FOLLOW_FILE"
+if [ "$(echo "$result" | grep "^  Count:")" = "  Count:    3" ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected a single refresh with Count 3"
+    echo "  Got: $result"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 43b: refresh options are rejected without --follow
+echo ""
+echo "Test 43b: --refresh-every and --refresh-interval need --follow"
+if ! err=$(echo '{"value":"1"}' | ./sensor-data stats --refresh-every 4 2>&1) && \
+   echo "$err" | grep -q "need --follow" && \
+   ! echo '{"value":"1"}' | ./sensor-data stats --refresh-interval 5 >/dev/null 2>&1; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected an error for refresh options without --follow"
+    echo "  Got: $err"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 44: --by-column matches a run per group
+echo ""
+echo "Test 44: --by-column table matches --only-value runs per sensor"
+GROUP_DIR=$(mktemp -d)
+for f in 1 2 3; do
+    for i in $(seq 1 300); do
+        echo "{\"sensor_id\":\"s$((i % 3))\",\"timestamp\":\"$((1699920000 + f * 86400 + i * 60))\",\"value\":\"$(( (i * f * 7) % 53 )).25\"}"
+    done > "$GROUP_DIR/part$f.out"
+done
+echo '{"timestamp":"1700000000","value":"5"}' > "$GROUP_DIR/nosensor.out"
+table=$(./sensor-data stats --by-column sensor_id "$GROUP_DIR" 2>&1)
+ok=true
+for sensor in s0 s1 s2; do
+    single=$(./sensor-data stats --only-value "sensor_id:$sensor" "$GROUP_DIR" 2>&1)
+    values=$(cat "$GROUP_DIR"/part*.out | grep "\"$sensor\"" | grep -o 'value":"[0-9.]*' | cut -d'"' -f3 | sort -n)
+    expected="$(echo "$single" | grep "^  Count:" | tr -s ' ' | cut -d' ' -f3) $(echo "$values" | head -1) $(echo "$values" | tail -1)"
+    got=$(echo "$table" | grep "^$sensor " | tr -s ' ' | cut -d' ' -f3-5)
+    [ "$expected" = "$got" ] || ok=false
+done
+if $ok && echo "$table" | grep -q "^(missing) *value *1 " && echo "$table" | grep -q "estimated"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Grouped counts, min and max should match per-sensor runs"
+    echo "  Got: $table"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 45: --by-day with CSV and JSON output
+echo ""
+echo "Test 45: --by-column --by-day as CSV and JSON"
+csv=$(./sensor-data stats -b sensor_id --by-day -of csv "$GROUP_DIR" 2>&1)
+json=$(./sensor-data stats -b sensor_id --by-day -of json "$GROUP_DIR" 2>&1)
+if [ "$(echo "$csv" | head -1)" = "sensor_id,day,column,count,min,max,mean,stddev,q1,median,q3,estimated" ] && \
+   [ "$(echo "$csv" | wc -l)" -eq 11 ] && \
+   echo "$csv" | grep -q "^s1,2023-11-15,value,100," && \
+   echo "$json" | grep -q '^\[{"sensor_id":"(missing)","day":"2023-11-14","column":"value","count":1,' && \
+   [ "$(echo "$json" | grep -o '"count"' | wc -l)" -eq 10 ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected a header and 10 sensor-day rows in each format"
+    echo "  CSV: $csv"
+    echo "  JSON: $json"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 46: grouped tables don't depend on -j, with or without --unique
+echo ""
+echo "Test 46: --by-column with -j4 matches -j1"
+cp "$GROUP_DIR/part1.out" "$GROUP_DIR/part4.out"
+result_j1=$(./sensor-data stats -b sensor_id -of csv -j 1 "$GROUP_DIR" 2>&1)
+result_j4=$(./sensor-data stats -b sensor_id -of csv -j 4 "$GROUP_DIR" 2>&1)
+unique_j1=$(./sensor-data stats -b sensor_id -of csv --unique -j 1 "$GROUP_DIR" 2>&1)
+unique_j4=$(./sensor-data stats -b sensor_id -of csv --unique -j 4 "$GROUP_DIR" 2>&1)
+if [ "$result_j1" = "$result_j4" ] && [ "$unique_j1" = "$unique_j4" ] && \
+   echo "$result_j1" | grep -q "^s0,value,400," && echo "$unique_j1" | grep -q "^s0,value,300,"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Grouped stats should not depend on -j"
+    diff <(echo "$result_j1") <(echo "$result_j4")
+    diff <(echo "$unique_j1") <(echo "$unique_j4")
+    FAILED=$((FAILED + 1))
+fi
+rm -rf "$GROUP_DIR"
+
+# Test 47: grouping option errors
+echo ""
+echo "Test 47: conflicting grouping options are rejected"
+if ! ./sensor-data stats --by-day --by-month "$TEST_DIR" >/dev/null 2>&1 && \
+   ! ./sensor-data stats -of csv "$TEST_DIR" >/dev/null 2>&1 && \
+   ! ./sensor-data stats -b sensor_id -of xml "$TEST_DIR" >/dev/null 2>&1; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected errors for two periods, -of without grouping and an unknown format"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 48: repeats within a file are dropped before the ordered merge
+echo ""
+echo "Test 48: --unique with rows repeated inside each file matches -j1"
+REPEAT_DIR=$(mktemp -d)
+for f in 1 2 3 4; do
+    for copy in 1 2 3; do
+        for i in $(seq 1 50); do
+            echo "{\"timestamp\":\"$(( (i % (f + 1)) * 100 + i ))\",\"value\":\"$(( (i * f) % 23 ))\"}"
+        done
+    done > "$REPEAT_DIR/part$f.out"
+done
+result_j1=$(./sensor-data stats --unique -j 1 "$REPEAT_DIR" 2>&1)
+result_j4=$(./sensor-data stats --unique -j 4 "$REPEAT_DIR" 2>&1)
+exact_j4=$(./sensor-data stats --unique-exact -j 4 "$REPEAT_DIR" 2>&1)
+rm -rf "$REPEAT_DIR"
+if [ "$result_j1" = "$result_j4" ] && [ "$result_j1" = "$exact_j4" ] && echo "$result_j1" | grep -q "Count:.*198"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --unique stats should not depend on -j or on repeats within a file"
+    echo "  -j1: $result_j1"
+    echo "  -j4: $result_j4"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 49: --unique-memory keeps its budget when more than 2 files are read
+echo ""
+echo "Test 49: --streaming --unique-memory stays small with -j 4 and 5 files"
+BUDGET_DIR=$(mktemp -d)
+for f in 1 2 3 4 5; do
+    awk -v f=$f 'BEGIN { for (n = 0; n < 200000; n++) printf "{\"timestamp\":\"%d\",\"value\":\"%d.%d\"}\n", f * 1000000 + n, n % 997, f }' > "$BUDGET_DIR/part$f.out"
+done
+./sensor-data stats --streaming --unique-memory 1 -j 4 "$BUDGET_DIR" > "$BUDGET_DIR/j4.txt" 2>&1 &
+pid=$!
+peak_kb=0
+while kill -0 $pid 2>/dev/null; do
+    rss_kb=$(awk '/^RssAnon/ { print $2 }' /proc/$pid/status 2>/dev/null)
+    if [ -n "$rss_kb" ] && [ "$rss_kb" -gt "$peak_kb" ]; then peak_kb=$rss_kb; fi
+done
+wait $pid
+result_j4=$(cat "$BUDGET_DIR/j4.txt")
+result_j1=$(./sensor-data stats --streaming --unique-memory 1 -j 1 "$BUDGET_DIR" 2>&1)
+rm -rf "$BUDGET_DIR"
+# Holding every file's rows for the ordered merge takes over 100 MB here
+if [ "$result_j1" = "$result_j4" ] && [ "$peak_kb" -lt 32768 ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected -j 4 to match -j 1 within 32 MB, peak was ${peak_kb} kB"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 50: --streaming --unique doesn't depend on -j
+echo ""
+echo "Test 50: --streaming --unique with -j4 matches -j1"
+SKETCH_DIR=$(mktemp -d)
+for f in 1 2 3 4 5 6; do
+    # Enough values for the sketch to estimate, with rows repeated across files
+    awk -v f=$f 'BEGIN { for (n = 0; n < 3000; n++) { k = (n * 7 + f * 131) % 5000; printf "{\"timestamp\":\"%d\",\"sensor_id\":\"s%d\",\"value\":\"%d.%d\"}\n", 1700000000 + k * 60, k % 3, (k * 37) % 1009, k % 10 } }' > "$SKETCH_DIR/part$f.out"
+done
+result_j1=$(./sensor-data stats --streaming --unique -j 1 "$SKETCH_DIR" 2>&1)
+result_j4=$(./sensor-data stats --streaming --unique -j 4 "$SKETCH_DIR" 2>&1)
+grouped_j1=$(./sensor-data stats --streaming --unique -b sensor_id -of csv -j 1 "$SKETCH_DIR" 2>&1)
+grouped_j4=$(./sensor-data stats --streaming --unique -b sensor_id -of csv -j 4 "$SKETCH_DIR" 2>&1)
+rm -rf "$SKETCH_DIR"
+if [ "$result_j1" = "$result_j4" ] && [ "$grouped_j1" = "$grouped_j4" ] && echo "$result_j1" | grep -q "Count:"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --streaming --unique stats should not depend on -j"
+    diff <(echo "$result_j1") <(echo "$result_j4")
+    FAILED=$((FAILED + 1))
+fi
+
 # Summary
 echo ""
 echo "================================"
@@ -7,6 +7,8 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include "../include/numeric_utils.h"
+#include "../include/percentiles.h"
 
 // We need to test private static methods, so we'll use a friend class workaround
 // Define the test to access protected/private methods
@@ -22,26 +24,13 @@ public:
 
 // Implementations copied from stats_analyser.cpp for isolated unit testing
 bool StatsAnalyser::isNumeric(const std::string& str) {
-    if (str.empty()) return false;
-    try {
-        size_t pos = 0;
-        std::stod(str, &pos);
-        return pos == str.length();
-    } catch (...) {
-        return false;
-    }
+    return NumericUtils::parseDouble(str).has_value();
 }
 
 double StatsAnalyser::calculateMedian(const std::vector<double>& values) {
     if (values.empty()) return 0.0;
-    std::vector<double> sorted = values;
-    std::sort(sorted.begin(), sorted.end());
-    size_t n = sorted.size();
-    if (n % 2 == 0) {
-        return (sorted[n/2 - 1] + sorted[n/2]) / 2.0;
-    } else {
-        return sorted[n/2];
-    }
+    std::vector<double> scratch = values;
+    return Percentiles::select(scratch, {50})[0];
 }
 
 double StatsAnalyser::calculateStdDev(const std::vector<double>& values, double mean) {
@@ -131,11 +120,16 @@ bool test_isNumeric_spaces() {
 }
 
 bool test_isNumeric_leading_spaces() {
-    // stod handles leading spaces but pos check catches trailing content
-    // " 123" -> stod parses as 123, pos = 4, length = 4, so it passes
+    // Leading whitespace is skipped, as std::stod does; trailing isn't
     ASSERT_TRUE(StatsAnalyser::isNumeric(" 123"));
 }
 
+bool test_isNumeric_non_finite() {
+    // stod reads these, but they would poison the mean and can't be sorted
+    ASSERT_FALSE(StatsAnalyser::isNumeric("nan") || StatsAnalyser::isNumeric("inf") ||
+                 StatsAnalyser::isNumeric("-Infinity"));
+}
+
 // ==================== calculateMedian tests ====================
 
 bool test_median_empty() {
@@ -209,6 +203,31 @@ bool test_stddev_two_values() {
     ASSERT_NEAR(StatsAnalyser::calculateStdDev(values, 15.0), 7.071, 0.01);
 }
 
+// ==================== Percentiles::select tests ====================
+
+bool test_select_percentiles_empty() {
+    std::vector<double> values;
+    ASSERT_EQ(Percentiles::select(values, {25, 50}), std::vector<double>({0.0, 0.0}));
+}
+
+bool test_select_percentiles_match_sorted() {
+    // Duplicates and sizes around the interpolation edge cases
+    for (size_t n = 1; n <= 40; ++n) {
+        std::vector<double> values;
+        for (size_t i = 0; i < n; ++i) values.push_back(static_cast<double>((i * 7919) % 13) - 4.5);
+        std::vector<double> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<double> percentiles = {50, 25, 75, 0, 100, 90, 25};
+        std::vector<double> selected = Percentiles::select(values, percentiles);
+        for (size_t i = 0; i < percentiles.size(); ++i) {
+            if (selected[i] != StatsAnalyser::calculatePercentile(sorted, percentiles[i])) {
+                ASSERT(false, "percentile " << percentiles[i] << " of " << n << " values differs");
+            }
+        }
+    }
+    ASSERT_TRUE(true);
+}
+
 // ==================== calculatePercentile tests ====================
 
 bool test_percentile_empty() {
@@ -279,6 +298,7 @@ int main() {
     std::cout << (test_isNumeric_mixed() ? "[PASS]" : "[FAIL]") << " test_isNumeric_mixed" << std::endl;
     std::cout << (test_isNumeric_spaces() ? "[PASS]" : "[FAIL]") << " test_isNumeric_spaces" << std::endl;
     std::cout << (test_isNumeric_leading_spaces() ? "[PASS]" : "[FAIL]") << " test_isNumeric_leading_spaces" << std::endl;
+    std::cout << (test_isNumeric_non_finite() ? "[PASS]" : "[FAIL]") << " test_isNumeric_non_finite" << std::endl;
     
     // calculateMedian tests
     std::cout << (test_median_empty() ? "[PASS]" : "[FAIL]") << " test_median_empty" << std::endl;
@@ -296,6 +316,10 @@ int main() {
     std::cout << (test_stddev_simple() ? "[PASS]" : "[FAIL]") << " test_stddev_simple" << std::endl;
     std::cout << (test_stddev_two_values() ? "[PASS]" : "[FAIL]") << " test_stddev_two_values" << std::endl;
     
+    // Percentiles::select tests
+    std::cout << (test_select_percentiles_empty() ? "[PASS]" : "[FAIL]") << " test_select_percentiles_empty" << std::endl;
+    std::cout << (test_select_percentiles_match_sorted() ? "[PASS]" : "[FAIL]") << " test_select_percentiles_match_sorted" << std::endl;
+    
     // calculatePercentile tests
     std::cout << (test_percentile_empty() ? "[PASS]" : "[FAIL]") << " test_percentile_empty" << std::endl;
     std::cout << (test_percentile_single() ? "[PASS]" : "[FAIL]") << " test_percentile_single" << std::endl;
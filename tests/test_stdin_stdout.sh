@@ -126,6 +126,16 @@ run_test "Pipe chain with output file" \
     "cat /tmp/test_stdin_json.txt | ./sensor-data transform -of csv -o /tmp/test_pipe.csv && cat /tmp/test_pipe.csv | wc -l" \
     "4"
 
+# Test 13: CSV header includes columns first seen after many rows
+run_test "CSV stdin header includes late columns" \
+    "(for i in \$(seq 1 2000); do echo '{\"sensor_id\":\"s1\",\"value\":\"1\"}'; done; echo '{\"sensor_id\":\"s2\",\"late\":\"x\"}') | ./sensor-data transform -of csv | head -1" \
+    "^late,sensor_id,value$"
+
+# Test 14: JSON stdin is written in input order
+run_test "JSON stdin streams rows in order" \
+    "printf '{\"n\":\"1\"}\\n{\"n\":\"2\"}\\n{\"n\":\"3\"}\\n' | ./sensor-data transform | tr -d ' \\n'" \
+    '^\[{"n":1}\]\[{"n":2}\]\[{"n":3}\]$'
+
 # Cleanup
 rm -f /tmp/test_stdin_json.txt /tmp/test_stdin_csv.txt /tmp/test_stdin_json_error.txt
 rm -f /tmp/test_output.csv /tmp/test_error_output.csv /tmp/test_pipe.csv
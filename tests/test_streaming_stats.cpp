@@ -0,0 +1,213 @@
+#include "../include/streaming_stats.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+static bool near(double a, double b, double tolerance = 1e-9) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+}
+
+// Same as StatsAnalyser::calculatePercentile
+static double percentileOf(std::vector<double> values, double p) {
+    std::sort(values.begin(), values.end());
+    if (values.size() == 1) return values[0];
+    double index = (p / 100.0) * (values.size() - 1);
+    size_t lower = static_cast<size_t>(index);
+    if (lower + 1 >= values.size()) return values.back();
+    return values[lower] + (index - lower) * (values[lower + 1] - values[lower]);
+}
+
+// Deterministic values with a trend, noise and a few spikes
+static std::vector<double> sampleValues(size_t n) {
+    std::vector<double> values;
+    uint64_t state = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        double noise = static_cast<double>(state >> 40) / static_cast<double>(1 << 24);
+        double value = 20.0 + 0.001 * static_cast<double>(i % 5000) + noise;
+        if (i % 997 == 0) value += 50.0;
+        values.push_back(value);
+    }
+    return values;
+}
+
+void test_running_stats_match_two_pass() {
+    // Large offset, small spread: a naive sum of squares would lose it
+    std::vector<double> values;
+    for (int i = 0; i < 1000; ++i) values.push_back(1e9 + (i % 7) * 0.25);
+
+    RunningStats stats;
+    for (double v : values) stats.add(v);
+
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    double mean = sum / values.size();
+    double squares = 0.0;
+    for (double v : values) squares += (v - mean) * (v - mean);
+    double stddev = std::sqrt(squares / (values.size() - 1));
+
+    assert(stats.count() == 1000);
+    assert(stats.min() == 1e9 && stats.max() == 1e9 + 1.5);
+    assert(near(stats.mean(), mean));
+    assert(near(stats.stddev(), stddev, 1e-6));
+    std::cout << "[PASS] test_running_stats_match_two_pass" << std::endl;
+}
+
+void test_running_stats_merge_equals_sequential() {
+    std::vector<double> values = sampleValues(5000);
+    RunningStats all, left, right;
+    for (size_t i = 0; i < values.size(); ++i) {
+        all.add(values[i]);
+        (i < 1234 ? left : right).add(values[i]);
+    }
+    RunningStats empty;
+    left.merge(right);
+    left.merge(empty);
+    empty.merge(left);
+
+    assert(empty.count() == all.count());
+    assert(empty.min() == all.min() && empty.max() == all.max());
+    assert(near(empty.mean(), all.mean()));
+    assert(near(empty.stddev(), all.stddev()));
+    std::cout << "[PASS] test_running_stats_merge_equals_sequential" << std::endl;
+}
+
+void test_sketch_exact_below_k() {
+    std::vector<double> values = sampleValues(QuantileSketch::DEFAULT_K - 1);
+    QuantileSketch sketch;
+    for (double v : values) sketch.add(v);
+
+    assert(sketch.exact());
+    for (double p : {0.0, 25.0, 50.0, 75.0, 90.0, 100.0}) {
+        assert(sketch.percentile(p) == percentileOf(values, p));
+    }
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    assert(sketch.select(0) == sorted.front());
+    assert(sketch.select(sorted.size() / 2) == sorted[sorted.size() / 2]);
+    assert(sketch.countBelow(sorted[10]) == 10);
+    assert(sketch.countAbove(sorted[sorted.size() - 4]) == 3);
+    std::cout << "[PASS] test_sketch_exact_below_k" << std::endl;
+}
+
+void test_sketch_rank_error_is_bounded() {
+    std::vector<double> values = sampleValues(200000);
+    QuantileSketch sketch;
+    for (double v : values) sketch.add(v);
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    assert(!sketch.exact());
+    assert(sketch.count() == values.size());
+    for (double p : {1.0, 25.0, 50.0, 75.0, 99.0}) {
+        double estimate = sketch.percentile(p);
+        // Rank of the estimate among the true values, against the one asked for
+        double rank = std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin();
+        assert(std::abs(rank / values.size() - p / 100.0) < 0.02);
+    }
+    double fence = percentileOf(values, 90);
+    double trueAbove = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), fence);
+    assert(std::abs(static_cast<double>(sketch.countAbove(fence)) - trueAbove) < 0.02 * values.size());
+    std::cout << "[PASS] test_sketch_rank_error_is_bounded" << std::endl;
+}
+
+void test_sketch_merge_keeps_count_and_accuracy() {
+    std::vector<double> values = sampleValues(100000);
+    std::vector<QuantileSketch> parts(7);
+    for (size_t i = 0; i < values.size(); ++i) parts[i * parts.size() / values.size()].add(values[i]);
+    QuantileSketch merged;
+    for (const auto& part : parts) merged.merge(part);
+
+    assert(merged.count() == values.size());
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    double median = merged.percentile(50);
+    double rank = std::lower_bound(sorted.begin(), sorted.end(), median) - sorted.begin();
+    assert(std::abs(rank / values.size() - 0.5) < 0.02);
+    std::cout << "[PASS] test_sketch_merge_keeps_count_and_accuracy" << std::endl;
+}
+
+void test_distribution_merge_in_any_order() {
+    std::vector<double> values = sampleValues(20000);
+    DistributionStats all, left, right;
+    for (size_t i = 0; i < values.size(); ++i) {
+        all.add(values[i]);
+        (i % 3 == 0 ? left : right).add(values[i]);
+    }
+    // Groups are merged in whatever order the workers finish
+    right.merge(left);
+
+    assert(right.valueStats().count() == all.valueStats().count());
+    assert(right.valueStats().min() == all.valueStats().min());
+    assert(right.valueStats().max() == all.valueStats().max());
+    assert(near(right.valueStats().mean(), all.valueStats().mean()));
+    assert(near(right.valueStats().stddev(), all.valueStats().stddev()));
+    assert(right.quantiles().count() == values.size());
+    double median = right.quantiles().percentile(50);
+    assert(std::abs(median - percentileOf(values, 50)) < 0.05 * (all.valueStats().max() - all.valueStats().min()));
+    std::cout << "[PASS] test_distribution_merge_in_any_order" << std::endl;
+}
+
+void test_series_append_matches_sequential_deltas() {
+    std::vector<double> values = {5, 7, 4, 4, 12, 11, 3, 3, 10, 9};
+    SeriesStats all;
+    for (double v : values) all.add(v);
+
+    // Split anywhere, including around the largest jump (4 -> 12)
+    for (size_t split = 0; split <= values.size(); ++split) {
+        SeriesStats head, tail;
+        for (size_t i = 0; i < values.size(); ++i) (i < split ? head : tail).add(values[i]);
+        head.append(tail);
+        assert(head.valueStats().count() == values.size());
+        assert(head.deltaStats().count() == values.size() - 1);
+        assert(head.deltaStats().min() == all.deltaStats().min());
+        assert(head.deltaStats().max() == 8);
+        assert(near(head.deltaStats().mean(), all.deltaStats().mean()));
+        assert(near(head.deltaStats().stddev(), all.deltaStats().stddev()));
+        assert(head.maxJumpFrom() == 4 && head.maxJumpTo() == 12);
+    }
+    // Ties keep the first jump, as the exact calculation does
+    SeriesStats ties;
+    for (double v : {1.0, 3.0, 1.0, 3.0}) ties.add(v);
+    assert(ties.maxJumpFrom() == 1 && ties.maxJumpTo() == 3);
+    std::cout << "[PASS] test_series_append_matches_sequential_deltas" << std::endl;
+}
+
+void test_timestamp_intervals_across_files() {
+    TimestampStats first, second, all;
+    for (long long ts : {100, 160, 220, 280}) { first.add(ts); all.add(ts); }
+    for (long long ts : {900, 960, 1020}) { second.add(ts); all.add(ts); }
+    first.append(second);
+
+    assert(first.count() == 7);
+    assert(first.earliest() == 100 && first.latest() == 1020);
+    assert(first.intervals().count() == 6);
+    assert(first.intervals().select(3) == 60);
+    assert(first.longestInterval() == 620);
+    assert(first.intervals().countAbove(180) == 1);
+    assert(all.longestInterval() == 620 && all.intervals().count() == 6);
+
+    // A timestamp that goes back in time is counted but adds no interval
+    TimestampStats unordered;
+    for (long long ts : {100, 200, 150, 300}) unordered.add(ts);
+    assert(unordered.count() == 4);
+    assert(unordered.earliest() == 100 && unordered.latest() == 300);
+    assert(unordered.intervals().count() == 2);
+    std::cout << "[PASS] test_timestamp_intervals_across_files" << std::endl;
+}
+
+int main() {
+    test_running_stats_match_two_pass();
+    test_running_stats_merge_equals_sequential();
+    test_sketch_exact_below_k();
+    test_sketch_rank_error_is_bounded();
+    test_sketch_merge_keeps_count_and_accuracy();
+    test_distribution_merge_in_any_order();
+    test_series_append_matches_sequential_deltas();
+    test_timestamp_intervals_across_files();
+    std::cout << "All streaming stats tests passed!" << std::endl;
+    return 0;
+}
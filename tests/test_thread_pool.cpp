@@ -0,0 +1,91 @@
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+void test_for_each_runs_every_task() {
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+    pool.forEach(hits.size(), [&](size_t i) { hits[i]++; });
+    for (int h : hits) {
+        assert(h == 1);
+    }
+    std::cout << "[PASS] test_for_each_runs_every_task" << std::endl;
+}
+
+void test_for_each_empty() {
+    ThreadPool pool(2);
+    pool.forEach(0, [](size_t) { assert(false); });
+    std::cout << "[PASS] test_for_each_empty" << std::endl;
+}
+
+void test_nested_for_each() {
+    // Every worker blocks in an inner forEach; they must run the inner tasks themselves
+    ThreadPool pool(2);
+    std::atomic<int> total(0);
+    pool.forEach(8, [&](size_t) {
+        pool.forEach(8, [&](size_t) { total++; });
+    });
+    assert(total == 64);
+    std::cout << "[PASS] test_nested_for_each" << std::endl;
+}
+
+void test_exception_propagates() {
+    ThreadPool pool(3);
+    std::atomic<int> ran(0);
+    bool caught = false;
+    try {
+        pool.forEach(20, [&](size_t i) {
+            ran++;
+            if (i == 5) throw std::runtime_error("task failed");
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+    assert(ran == 20);  // Other tasks still run to completion
+    std::cout << "[PASS] test_exception_propagates" << std::endl;
+}
+
+void test_pool_reusable() {
+    ThreadPool pool(3);
+    for (int round = 0; round < 50; ++round) {
+        std::atomic<int> count(0);
+        pool.forEach(round, [&](size_t) { count++; });
+        assert(count == round);
+    }
+    std::cout << "[PASS] test_pool_reusable" << std::endl;
+}
+
+void test_sort_matches_std_sort() {
+    // Odd pool sizes leave an unpaired run in some merge rounds
+    for (size_t threads : {1, 2, 3, 5}) {
+        ThreadPool pool(threads);
+        std::vector<long long> values;
+        unsigned long long state = 42;
+        for (size_t i = 0; i < 300000; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values.push_back(static_cast<long long>(state >> 44) - 500000);
+        }
+        std::vector<long long> expected = values;
+        std::sort(expected.begin(), expected.end());
+        pool.sort(values.begin(), values.end());
+        assert(values == expected);
+    }
+    std::cout << "[PASS] test_sort_matches_std_sort" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Thread Pool Tests..." << std::endl;
+    test_for_each_runs_every_task();
+    test_for_each_empty();
+    test_nested_for_each();
+    test_exception_propagates();
+    test_pool_reusable();
+    test_sort_matches_std_sort();
+    std::cout << "All Thread Pool tests passed!" << std::endl;
+    return 0;
+}
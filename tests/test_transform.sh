@@ -1208,6 +1208,117 @@ else
     FAILED=$((FAILED + 1))
 fi
 
+# Test 43: Parallel output keeps file order and first-occurrence --unique
+echo ""
+echo "Test 43: -j 4 output matches -j 1 across many files with --unique"
+mkdir -p testdir
+for i in 1 2 3 4 5 6; do
+    echo "[ { \"sensor\": \"ds18b20\", \"value\": \"$i\" } ]
+[ { \"sensor\": \"ds18b20\", \"value\": \"dup\", \"file\": \"x\" } ]
+[ { \"sensor\": \"dht22\", \"value\": \"$i\" } ]" > testdir/file$i.out
+done
+serial=$(./sensor-data transform -j 1 --unique -of csv testdir/ 2>/dev/null)
+parallel=$(./sensor-data transform -j 4 --unique -of csv testdir/ 2>/dev/null)
+serial_json=$(./sensor-data transform -j 1 --unique testdir/ 2>/dev/null)
+parallel_json=$(./sensor-data transform -j 4 --unique testdir/ 2>/dev/null)
+rm -rf testdir
+count=$(echo "$parallel" | grep -c "dup" || true)
+if [ "$serial" = "$parallel" ] && [ "$serial_json" = "$parallel_json" ] && [ "$count" -eq 1 ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Parallel output differs from sequential output"
+    echo "  Got: $parallel"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 44: --single-pass matches the two-pass output
+echo ""
+echo "Test 44: --single-pass output matches two-pass output"
+mkdir -p testdir
+for i in 1 2 3; do
+    echo "[ { \"sensor\": \"ds18b20\", \"value\": \"$i\" } ]
+[ { \"sensor\": \"dht22\", \"humidity\": \"4$i\", \"note\": \"a,b\" } ]" > testdir/file$i.out
+done
+two_pass=$(./sensor-data transform -of csv testdir/ 2>/dev/null)
+one_pass=$(./sensor-data transform --single-pass -of csv testdir/ 2>/dev/null)
+one_pass_json=$(./sensor-data transform --single-pass testdir/ 2>/dev/null)
+two_pass_json=$(./sensor-data transform testdir/ 2>/dev/null)
+rm -rf testdir
+header=$(echo "$one_pass" | head -1)
+if [ "$two_pass" = "$one_pass" ] && [ "$two_pass_json" = "$one_pass_json" ] && [ "$header" = "humidity,note,sensor,value" ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --single-pass output differs"
+    echo "  Got: $one_pass"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 45: --schema-cache reuses keys of unchanged files and re-reads changed ones
+echo ""
+echo "Test 45: --schema-cache picks up new columns in appended files"
+mkdir -p testdir
+echo '[ { "sensor": "ds18b20", "value": "1" } ]' > testdir/file1.out
+echo '[ { "sensor": "ds18b20", "value": "2" } ]' > testdir/file2.out
+first=$(./sensor-data transform --schema-cache testdir/cache -of csv testdir/file1.out testdir/file2.out 2>/dev/null | head -1)
+echo '[ { "sensor": "dht22", "humidity": "40" } ]' >> testdir/file2.out
+second=$(./sensor-data transform --schema-cache testdir/cache -of csv testdir/file1.out testdir/file2.out 2>/dev/null | head -1)
+cached=$(test -f testdir/cache/schema-cache.tsv && echo yes)
+rm -rf testdir
+if [ "$first" = "sensor,value" ] && [ "$second" = "humidity,sensor,value" ] && [ "$cached" = "yes" ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Expected headers 'sensor,value' then 'humidity,sensor,value'"
+    echo "  Got: '$first' then '$second'"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 46: --unique-memory spills seen rows but keeps --unique output
+echo ""
+echo "Test 46: --unique-memory output matches --unique"
+mkdir -p testdir
+# Enough rows to overflow a 1 MB budget, with repeats across and within files
+for i in 1 2 3; do
+    awk -v f=$i 'BEGIN { for (n = 0; n < 40000; n++) printf "{\"sensor_id\":\"s%d\",\"value\":\"%d\"}\n", (n * f) % 7, (n * f) % 50000 }' > testdir/file$i.out
+done
+in_memory=$(./sensor-data transform --unique -of csv testdir/ 2>/dev/null | md5sum)
+bounded=$(./sensor-data transform --unique-memory 1 -of csv testdir/ 2>/dev/null | md5sum)
+bounded_j1=$(./sensor-data transform --unique-memory 1 -j 1 -of csv testdir/ 2>/dev/null | md5sum)
+bounded_j4=$(./sensor-data transform --unique-memory 1 -j 4 -of csv testdir/ 2>/dev/null | md5sum)
+rm -rf testdir
+if [ "$in_memory" = "$bounded" ] && [ "$in_memory" = "$bounded_j1" ] && [ "$in_memory" = "$bounded_j4" ]; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - --unique-memory output differs from --unique"
+    FAILED=$((FAILED + 1))
+fi
+
+# Test 47: files larger than one output batch, and -v notes, match -j 1
+echo ""
+echo "Test 47: -j 4 matches -j 1 for multi-batch files and -v --tail notes"
+mkdir -p testdir
+# About 2 MB of CSV per file, with repeats within each file
+for i in 1 2 3 4; do
+    awk -v f=$i 'BEGIN { for (n = 0; n < 60000; n++) printf "{\"sensor_id\":\"s%d\",\"value\":\"%d\",\"note\":\"file %d row %d\"}\n", n % 5, (n * f) % 997, f, n % 20000 }' > testdir/file$i.out
+done
+serial=$(./sensor-data transform -j 1 --unique -of csv testdir/ 2>/dev/null | md5sum)
+parallel=$(./sensor-data transform -j 4 --unique -of csv testdir/ 2>/dev/null | md5sum)
+serial_notes=$(./sensor-data transform -v --tail 2 -j 1 -of csv -o testdir/out1.csv testdir/file*.out 2>&1 | sed -n '/Pass 2/,$p' | grep -v "^Wrote")
+parallel_notes=$(./sensor-data transform -v --tail 2 -j 4 -of csv -o testdir/out4.csv testdir/file*.out 2>&1 | sed -n '/Pass 2/,$p' | grep -v "^Wrote")
+rm -rf testdir
+if [ "$serial" = "$parallel" ] && [ "$serial_notes" = "$parallel_notes" ] && echo "$parallel_notes" | grep -q "reading last 2 lines only"; then
+    echo "  ✓ PASS"
+    PASSED=$((PASSED + 1))
+else
+    echo "  ✗ FAIL - Parallel output or -v notes differ from sequential"
+    echo "  -j1: $serial_notes"
+    echo "  -j4: $parallel_notes"
+    FAILED=$((FAILED + 1))
+fi
+
 # Summary
 echo ""
 echo "================================"
@@ -0,0 +1,184 @@
+#include "../include/types.h"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+void test_reading_initializer_and_lookup() {
+    Reading reading = {{"sensor_id", "s1"}, {"value", "22.5"}};
+    assert(reading.size() == 2);
+    assert(reading.count("sensor_id") == 1);
+    assert(reading.count("missing") == 0);
+    assert(reading.at("value") == "22.5");
+    assert(reading.find("missing") == reading.end());
+    std::cout << "[PASS] test_reading_initializer_and_lookup" << std::endl;
+}
+
+void test_reading_emplace_keeps_first_value() {
+    Reading reading;
+    assert(reading.emplace("k", "first").second);
+    assert(!reading.emplace("k", "second").second);
+    assert(reading.size() == 1);
+    assert(reading.at("k") == "first");
+    std::cout << "[PASS] test_reading_emplace_keeps_first_value" << std::endl;
+}
+
+void test_reading_subscript_inserts_empty() {
+    Reading reading;
+    assert(reading["new"].empty());
+    assert(reading.size() == 1);
+    reading["new"] = "set";
+    assert(reading.at("new") == "set");
+    std::cout << "[PASS] test_reading_subscript_inserts_empty" << std::endl;
+}
+
+void test_reading_at_throws_on_missing() {
+    Reading reading;
+    bool threw = false;
+    try {
+        reading.at("missing");
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "[PASS] test_reading_at_throws_on_missing" << std::endl;
+}
+
+void test_reading_erase_preserves_order() {
+    Reading reading = {{"a", "1"}, {"b", "2"}, {"c", "3"}};
+    assert(reading.erase("b") == 1);
+    assert(reading.erase("b") == 0);
+    assert(reading.size() == 2);
+    assert(reading.begin()->first == "a");
+    assert((reading.begin() + 1)->first == "c");
+    std::cout << "[PASS] test_reading_erase_preserves_order" << std::endl;
+}
+
+void test_reading_equality_ignores_order() {
+    Reading a = {{"x", "1"}, {"y", "2"}};
+    Reading b = {{"y", "2"}, {"x", "1"}};
+    Reading c = {{"x", "1"}, {"y", "3"}};
+    assert(a == b);
+    assert(a != c);
+    std::cout << "[PASS] test_reading_equality_ignores_order" << std::endl;
+}
+
+void test_reading_clear_and_refill() {
+    Reading reading = {{"a", "a fairly long value that is not SSO"}, {"b", "2"}};
+    reading.clear();
+    assert(reading.empty());
+    assert(reading.find("a") == reading.end());
+    reading.emplace("c", "3");
+    assert(reading.size() == 1);
+    assert(reading.at("c") == "3");
+    // Copies only carry live fields
+    Reading copy = reading;
+    assert(copy.size() == 1);
+    assert(copy == reading);
+    std::cout << "[PASS] test_reading_clear_and_refill" << std::endl;
+}
+
+void test_reading_map_round_trip() {
+    ReadingMap map = {{"sensor", "ds18b20"}, {"value", "85"}};
+    Reading reading(map);
+    assert(reading.size() == 2);
+    assert(reading.at("sensor") == "ds18b20");
+    assert(reading.toMap() == map);
+    std::cout << "[PASS] test_reading_map_round_trip" << std::endl;
+}
+
+void test_field_key_interning() {
+    FieldKey a("location");
+    FieldKey b(std::string("location"));
+    FieldKey c("elsewhere");
+    assert(a == b);
+    assert(a.id() == b.id());
+    assert(a != c);
+    assert(a.str() == "location");
+    assert(a == "location");
+    assert(std::string("location") == a);
+    std::cout << "[PASS] test_field_key_interning" << std::endl;
+}
+
+void test_field_key_builtins() {
+    assert(FieldKey("sensor_id") == Keys::SensorId);
+    assert(FieldKey("timestamp") == Keys::Timestamp);
+    assert(FieldKey("value") == Keys::Value);
+    assert(Keys::Sensor.str() == "sensor");
+    assert(FieldKey().empty());
+    std::cout << "[PASS] test_field_key_builtins" << std::endl;
+}
+
+void test_field_key_orders_by_name() {
+    // Intern "zeta" before "alpha" so ID order and name order disagree
+    FieldKey z("zeta_order");
+    FieldKey a("alpha_order");
+    assert(z.id() < a.id());
+    assert(a < z);
+    assert(!(z < a));
+    assert(!(a < a));
+    std::cout << "[PASS] test_field_key_orders_by_name" << std::endl;
+}
+
+void test_field_key_threads_agree() {
+    const int threadCount = 4;
+    const int keyCount = 2000;
+    std::vector<std::vector<uint32_t>> ids(threadCount, std::vector<uint32_t>(keyCount));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < keyCount; ++i) {
+                ids[t][i] = FieldKey("threaded_" + std::to_string(i)).id();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t = 1; t < threadCount; ++t) {
+        assert(ids[t] == ids[0]);
+    }
+    assert(FieldKey::fromId(ids[0][keyCount - 1]).str() == "threaded_" + std::to_string(keyCount - 1));
+    std::cout << "[PASS] test_field_key_threads_agree" << std::endl;
+}
+
+void test_field_key_names_survive_growth() {
+    // Enough names to fill several chunks; earlier names must stay in place
+    std::vector<FieldKey> keys;
+    for (int i = 0; i < 20000; ++i) {
+        keys.push_back(FieldKey("grown_" + std::to_string(i)));
+    }
+    for (int i = 0; i < 20000; ++i) {
+        assert(keys[i].str() == "grown_" + std::to_string(i));
+        assert(FieldKey("grown_" + std::to_string(i)) == keys[i]);
+    }
+    std::cout << "[PASS] test_field_key_names_survive_growth" << std::endl;
+}
+
+void test_reading_lookup_by_key() {
+    Reading reading = {{"sensor_id", "s1"}, {"value", "22.5"}};
+    auto it = reading.find(Keys::Value);
+    assert(it != reading.end());
+    assert(it->first == Keys::Value);
+    assert(it->second == "22.5");
+    assert(reading.at(Keys::SensorId) == "s1");
+    std::cout << "[PASS] test_reading_lookup_by_key" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Reading Type Tests..." << std::endl;
+    test_reading_initializer_and_lookup();
+    test_reading_emplace_keeps_first_value();
+    test_reading_subscript_inserts_empty();
+    test_reading_at_throws_on_missing();
+    test_reading_erase_preserves_order();
+    test_reading_equality_ignores_order();
+    test_reading_clear_and_refill();
+    test_reading_map_round_trip();
+    test_field_key_interning();
+    test_field_key_builtins();
+    test_field_key_orders_by_name();
+    test_field_key_threads_agree();
+    test_field_key_names_survive_growth();
+    test_reading_lookup_by_key();
+    std::cout << "All Reading Type tests passed!" << std::endl;
+    return 0;
+}